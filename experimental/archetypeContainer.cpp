@@ -0,0 +1,223 @@
+#include "archetypeContainer.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace EECS;
+
+constexpr size_t Archetype::chunkSize;
+constexpr size_t Archetype::chunkAlignment;
+
+Archetype::Archetype(std::vector<const ComponentTypeInfo*> types) : types(std::move(types)) {
+    columnOffsets.resize(this->types.size());
+
+    size_t bytesPerEntity = sizeof(EntityID);
+    for (auto type : this->types) {
+        bytesPerEntity += type->size;
+    }
+
+    // estimate ignores alignment padding, so shrink capacity until layout fits in the chunk
+    chunkCapacity = std::max<size_t>(chunkSize / bytesPerEntity, 1);
+    while (chunkCapacity > 1 && layout(chunkCapacity) > chunkSize) {
+        chunkCapacity--;
+    }
+    layout(chunkCapacity);
+}
+
+Archetype::~Archetype() { clear(); }
+
+int Archetype::columnIndex(size_t typeID) const {
+    auto typeIt = std::lower_bound(types.begin(), types.end(), typeID,
+                                   [](const ComponentTypeInfo* type, size_t typeID) { return type->id < typeID; });
+
+    if (typeIt == types.end() || (*typeIt)->id != typeID) {
+        return -1;
+    }
+
+    return (int)(typeIt - types.begin());
+}
+
+bool Archetype::hasTypes(const size_t* typeIDs, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        if (columnIndex(typeIDs[i]) == -1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t Archetype::chunkSizeAt(size_t chunk) const {
+    auto firstSlot = chunk * chunkCapacity;
+    if (firstSlot >= entityCount) {
+        return 0;
+    }
+
+    return std::min(chunkCapacity, entityCount - firstSlot);
+}
+
+void* Archetype::component(size_t slot, size_t columnIndex) {
+    return (char*)column(slot / chunkCapacity, columnIndex) + (slot % chunkCapacity) * types[columnIndex]->size;
+}
+
+size_t Archetype::allocate(EntityID entity) {
+    auto slot = entityCount;
+    if (slot / chunkCapacity >= chunks.size()) {
+        Chunk chunk;
+        chunk.memory = std::make_unique<char[]>(chunkSize + chunkAlignment);
+        auto address = (uintptr_t)chunk.memory.get();
+        chunk.data = chunk.memory.get() + (chunkAlignment - address % chunkAlignment) % chunkAlignment;
+        chunks.push_back(std::move(chunk));
+    }
+
+    entities(slot / chunkCapacity)[slot % chunkCapacity] = entity;
+    entityCount++;
+
+    return slot;
+}
+
+EntityID Archetype::deallocate(size_t slot) {
+    auto last = entityCount - 1;
+
+    for (size_t column = 0; column < types.size(); column++) {
+        types[column]->destroy(component(slot, column));
+
+        if (slot != last) {
+            types[column]->moveConstruct(component(slot, column), component(last, column));
+            types[column]->destroy(component(last, column));
+        }
+    }
+
+    EntityID moved = 0;
+    if (slot != last) {
+        moved = entity(last);
+        entities(slot / chunkCapacity)[slot % chunkCapacity] = moved;
+    }
+
+    entityCount--;
+    return moved;
+}
+
+void Archetype::clear() {
+    for (size_t slot = 0; slot < entityCount; slot++) {
+        for (size_t column = 0; column < types.size(); column++) {
+            types[column]->destroy(component(slot, column));
+        }
+    }
+
+    entityCount = 0;
+    chunks.clear();
+}
+
+size_t Archetype::layout(size_t capacity) {
+    auto offset = sizeof(EntityID) * capacity;
+
+    for (size_t column = 0; column < types.size(); column++) {
+        auto alignment = types[column]->alignment;
+        offset = (offset + alignment - 1) / alignment * alignment;
+        columnOffsets[column] = offset;
+        offset += types[column]->size * capacity;
+    }
+
+    return offset;
+}
+
+ArchetypeContainer::ArchetypeContainer() { findOrCreateArchetype({}); }
+
+bool ArchetypeContainer::deleteEntity(EntityID entityID) {
+    auto locationIt = locations.find(entityID);
+    if (locationIt == locations.end()) {
+        return false;
+    }
+
+    auto& location = locationIt->second;
+    auto moved = location.archetype->deallocate(location.slot);
+    if (moved != 0) {
+        locations[moved].slot = location.slot;
+    }
+
+    locations.erase(entityID);
+    return true;
+}
+
+void ArchetypeContainer::clear() {
+    for (auto& archetype : archetypes) {
+        archetype->clear();
+    }
+
+    locations.clear();
+}
+
+ArchetypeContainer::EntityLocation& ArchetypeContainer::locate(EntityID entityID) {
+    auto locationIt = locations.find(entityID);
+    if (locationIt != locations.end()) {
+        return locationIt->second;
+    }
+
+    auto emptyArchetype = archetypes.front().get();
+    return locations[entityID] = {emptyArchetype, emptyArchetype->allocate(entityID)};
+}
+
+Archetype* ArchetypeContainer::findOrCreateArchetype(std::vector<const ComponentTypeInfo*> types) {
+    for (auto& archetype : archetypes) {
+        if (archetype->getTypes() == types) {
+            return archetype.get();
+        }
+    }
+
+    archetypes.push_back(std::make_unique<Archetype>(std::move(types)));
+    return archetypes.back().get();
+}
+
+Archetype* ArchetypeContainer::withType(Archetype* source, const ComponentTypeInfo& type) {
+    auto edge = source->addEdges.find(type.id);
+    if (edge != source->addEdges.end()) {
+        return edge->second;
+    }
+
+    auto types = source->getTypes();
+    types.insert(std::lower_bound(types.begin(), types.end(), &type,
+                                  [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) { return a->id < b->id; }),
+                 &type);
+
+    auto target = findOrCreateArchetype(std::move(types));
+    source->addEdges[type.id] = target;
+    target->removeEdges[type.id] = source;
+    return target;
+}
+
+Archetype* ArchetypeContainer::withoutType(Archetype* source, const ComponentTypeInfo& type) {
+    auto edge = source->removeEdges.find(type.id);
+    if (edge != source->removeEdges.end()) {
+        return edge->second;
+    }
+
+    auto types = source->getTypes();
+    types.erase(std::remove(types.begin(), types.end(), &type), types.end());
+
+    auto target = findOrCreateArchetype(std::move(types));
+    source->removeEdges[type.id] = target;
+    target->addEdges[type.id] = source;
+    return target;
+}
+
+void ArchetypeContainer::migrate(EntityID entityID, EntityLocation& location, Archetype* target) {
+    auto source = location.archetype;
+    auto targetSlot = target->allocate(entityID);
+
+    const auto& sourceTypes = source->getTypes();
+    for (size_t column = 0; column < sourceTypes.size(); column++) {
+        auto targetColumn = target->columnIndex(sourceTypes[column]->id);
+        if (targetColumn != -1) {
+            sourceTypes[column]->moveConstruct(target->component(targetSlot, targetColumn),
+                                               source->component(location.slot, column));
+        }
+    }
+
+    // moved-from components are destroyed here, together with components absent in target archetype
+    auto moved = source->deallocate(location.slot);
+    if (moved != 0) {
+        locations[moved].slot = location.slot;
+    }
+
+    location = {target, targetSlot};
+}
@@ -0,0 +1,257 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <tuple>
+#include <new>
+#include <type_traits>
+#include "core/entityID.h"
+#include "core/componentContainerID.h"
+#include "core/component.h"
+
+namespace EECS {
+
+// Type-erased description of a component type, sufficient to relocate components between archetype chunks.
+struct ComponentTypeInfo {
+    size_t id;
+    size_t size;
+    size_t alignment;
+    void (*moveConstruct)(void* destination, void* source);
+    void (*destroy)(void* object);
+
+    template <class T>
+    static const ComponentTypeInfo& of() {
+        static const ComponentTypeInfo info{ComponentContainerID::get<T>(), sizeof(T), alignof(T),
+                                            [](void* destination, void* source) {
+                                                new (destination) T(std::move(*(T*)source));
+                                            },
+                                            [](void* object) { ((T*)object)->~T(); }};
+        return info;
+    }
+};
+
+/** \brief set of entities which have exactly the same component types(the same signature).
+*
+* Components are stored in fixed-size chunks, in structure-of-arrays layout: each chunk begins with array of entity
+* ids, followed by one array per component type. Slots are numbered globally across chunks, so slot / capacity is
+* chunk index and slot % capacity is index inside of chunk. Archetype is always densely packed - removing an entity
+* moves the last one into its slot.
+*/
+class Archetype {
+   public:
+    static constexpr size_t chunkSize = 16 * 1024;
+    static constexpr size_t chunkAlignment = 64;
+
+    // types must be sorted by id and unique.
+    explicit Archetype(std::vector<const ComponentTypeInfo*> types);
+    ~Archetype();
+
+    const std::vector<const ComponentTypeInfo*>& getTypes() const { return types; }
+
+    // returns index of column holding components of given type, or -1 if archetype doesn't have this type.
+    int columnIndex(size_t typeID) const;
+
+    // checks if archetype has all of given types.
+    bool hasTypes(const size_t* typeIDs, size_t count) const;
+
+    size_t size() const { return entityCount; }
+    size_t chunkCount() const { return chunks.size(); }
+    size_t getChunkCapacity() const { return chunkCapacity; }
+
+    // number of entities stored in given chunk.
+    size_t chunkSizeAt(size_t chunk) const;
+
+    EntityID* entities(size_t chunk) { return (EntityID*)chunks[chunk].data; }
+    void* column(size_t chunk, size_t columnIndex) { return chunks[chunk].data + columnOffsets[columnIndex]; }
+    void* component(size_t slot, size_t columnIndex);
+    EntityID entity(size_t slot) { return entities(slot / chunkCapacity)[slot % chunkCapacity]; }
+
+    // appends entity to the archetype and returns its slot. Components in this slot are left uninitialized, caller
+    // must construct every one of them.
+    size_t allocate(EntityID entity);
+
+    // destroys all components in given slot, and moves the last entity into it. Returns id of moved entity, or 0 if
+    // no entity was moved(slot was the last one).
+    EntityID deallocate(size_t slot);
+
+    // destroys all components and frees all chunks.
+    void clear();
+
+   private:
+    struct Chunk {
+        std::unique_ptr<char[]> memory;
+        char* data;
+    };
+
+    std::vector<const ComponentTypeInfo*> types;
+    std::vector<size_t> columnOffsets;
+    std::vector<Chunk> chunks;
+    size_t chunkCapacity = 0;
+    size_t entityCount = 0;
+
+    // cached transitions to archetypes with one component type added/removed, used by ArchetypeContainer.
+    std::unordered_map<size_t, Archetype*> addEdges;
+    std::unordered_map<size_t, Archetype*> removeEdges;
+
+    // computes column offsets for given capacity. Returns number of bytes needed by a chunk.
+    size_t layout(size_t capacity);
+
+    friend class ArchetypeContainer;
+};
+
+/** \brief experimental, standalone container, which groups entities by their component signature.
+*
+* Unlike ComponentManager, which keeps separate container for every component type, ArchetypeContainer keeps all
+* components of an entity together, in an Archetype matching entity's set of component types. Query over several
+* component types(forEach) visits only archetypes which have all of them and walks their chunks linearly, without any
+* per-entity lookups.
+*
+* Adding or deleting component changes entity's signature, so the entity is migrated to other archetype: its
+* components are moved there, and the hole in previous archetype is filled by its last entity. Transitions between
+* archetypes are cached, so migration costs only moving components. Pointers to components are invalidated by
+* any structural change of the archetype they belong to.
+*
+* It's not a storage policy(see componentStorage.h) - ComponentManager and ECS don't use it, so it's kept out of the
+* library and include/ecs/ecs.h until it's integrated with them, and built only with its tests. Entities are just ids
+* here, existence of entities isn't checked, and none of ComponentManager's facilities applies: access declared by
+* Tasks isn't validated, CommandBuffers, signatures of entities, cached queries and change tracking don't see its
+* components. It's meant for evaluating archetype layout on self-contained data, and may change or be removed.
+*/
+class ArchetypeContainer {
+   public:
+    ArchetypeContainer();
+
+    // Adds component to entity, replacing existing one. Arguments after entityID are forwarded to constructor of the
+    // component. Returns pointer to created component, or nullptr if entityID is 0.
+    template <class T, class... Args>
+    T* addComponent(EntityID entityID, Args&&... args) {
+        static_assert(std::is_base_of<Component<T>, T>::value, "T must be a component type!");
+        static_assert(alignof(T) <= Archetype::chunkAlignment, "Component alignment exceeds chunk alignment!");
+        if (entityID == 0) {
+            return nullptr;
+        }
+
+        // constructed up front, as arguments may refer to components which are about to be relocated.
+        T component(std::forward<Args>(args)...);
+        component.entityID = entityID;
+
+        const auto& type = ComponentTypeInfo::of<T>();
+        auto& location = locate(entityID);
+        auto column = location.archetype->columnIndex(type.id);
+        if (column != -1) {
+            auto existing = (T*)location.archetype->component(location.slot, column);
+            *existing = std::move(component);
+            return existing;
+        }
+
+        migrate(entityID, location, withType(location.archetype, type));
+        auto place = location.archetype->component(location.slot, location.archetype->columnIndex(type.id));
+        return new (place) T(std::move(component));
+    }
+
+    // Deletes component owned by given entity, migrating the entity to archetype without it. Returns true if it was
+    // deleted, false if it didn't exist.
+    template <class T>
+    bool deleteComponent(EntityID entityID) {
+        const auto& type = ComponentTypeInfo::of<T>();
+        auto locationIt = locations.find(entityID);
+        if (locationIt == locations.end() || locationIt->second.archetype->columnIndex(type.id) == -1) {
+            return false;
+        }
+
+        migrate(entityID, locationIt->second, withoutType(locationIt->second.archetype, type));
+        return true;
+    }
+
+    // returns pointer to component of type T owned by given entity, or nullptr if it doesn't exist.
+    template <class T>
+    T* getComponent(EntityID entityID) {
+        auto locationIt = locations.find(entityID);
+        if (locationIt == locations.end()) {
+            return nullptr;
+        }
+
+        auto& location = locationIt->second;
+        auto column = location.archetype->columnIndex(ComponentContainerID::get<T>());
+        return column == -1 ? nullptr : (T*)location.archetype->component(location.slot, column);
+    }
+
+    // Deletes all components of given entity. Returns false if entity wasn't stored here.
+    bool deleteEntity(EntityID entityID);
+
+    // Deletes all components. Archetypes are preserved, so repopulating container won't recreate them.
+    void clear();
+
+    /** \brief calls function(EntityID, Head&, Tail&...) for every entity which has at least given component types
+    *
+    * Iterates chunks of matching archetypes linearly. Components of entity can be modified, but container must not be
+    * structurally changed(adding/deleting components or entities) during iteration.
+    */
+    template <class Head, class... Tail, class Function>
+    void forEach(Function&& function) {
+        const size_t typeIDs[] = {ComponentContainerID::get<Head>(), ComponentContainerID::get<Tail>()...};
+
+        for (auto& archetype : archetypes) {
+            if (archetype->size() == 0 || !archetype->hasTypes(typeIDs, 1 + sizeof...(Tail))) {
+                continue;
+            }
+
+            const int columns[] = {archetype->columnIndex(ComponentContainerID::get<Head>()),
+                                   archetype->columnIndex(ComponentContainerID::get<Tail>())...};
+            forEachInArchetype<Head, Tail...>(*archetype, columns, function,
+                                               std::index_sequence_for<Head, Tail...>{});
+        }
+    }
+
+    // number of entities which have at least given component types.
+    template <class Head, class... Tail>
+    size_t count() {
+        const size_t typeIDs[] = {ComponentContainerID::get<Head>(), ComponentContainerID::get<Tail>()...};
+
+        size_t result = 0;
+        for (auto& archetype : archetypes) {
+            if (archetype->hasTypes(typeIDs, 1 + sizeof...(Tail))) {
+                result += archetype->size();
+            }
+        }
+
+        return result;
+    }
+
+    size_t archetypeCount() const { return archetypes.size(); }
+
+   private:
+    struct EntityLocation {
+        Archetype* archetype;
+        size_t slot;
+    };
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<EntityID, EntityLocation> locations;
+
+    // returns location of the entity, placing it in empty archetype if it isn't stored yet.
+    EntityLocation& locate(EntityID entityID);
+
+    Archetype* findOrCreateArchetype(std::vector<const ComponentTypeInfo*> types);
+    Archetype* withType(Archetype* source, const ComponentTypeInfo& type);
+    Archetype* withoutType(Archetype* source, const ComponentTypeInfo& type);
+
+    // moves components of entity which are present in target archetype, destroys remaining ones, and updates location.
+    void migrate(EntityID entityID, EntityLocation& location, Archetype* target);
+
+    template <class... Types, class Function, size_t... Indices>
+    void forEachInArchetype(Archetype& archetype, const int* columns, Function& function,
+                            std::index_sequence<Indices...>) {
+        for (size_t chunk = 0; chunk < archetype.chunkCount(); chunk++) {
+            auto count = archetype.chunkSizeAt(chunk);
+            auto entities = archetype.entities(chunk);
+            auto arrays = std::make_tuple((Types*)archetype.column(chunk, columns[Indices])...);
+
+            for (size_t i = 0; i < count; i++) {
+                function(entities[i], std::get<Indices>(arrays)[i]...);
+            }
+        }
+    }
+};
+}
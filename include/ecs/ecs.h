@@ -6,6 +6,7 @@
 #include "../src/core/event.h"
 #include "../src/core/receives.h"
 #include "../src/core/task.h"
+#include "../src/core/commandBuffer.h"
 
 #include "../src/utils/logger.h"
 #include "../src/utils/loggerConsoleOutput.h"
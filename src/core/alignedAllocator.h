@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+namespace EECS {
+// alignment of component arrays - size of cache line, and of widest(AVX-512) vector register.
+constexpr size_t componentAlignment = 64;
+
+// Allocator returning memory aligned to Alignment bytes. Size of each allocation is rounded up to multiple of
+// Alignment, so vectorized loop may load full register from the last, partially filled block of an array without
+// reading past the allocation. Elements in the padding are not constructed and shouldn't be stored to.
+template <class T, size_t Alignment = componentAlignment>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be power of two, not smaller than alignment of T!");
+
+   public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        if (count > (std::numeric_limits<size_t>::max() - 2 * Alignment) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+
+        auto bytes = (count * sizeof(T) + Alignment - 1) & ~(Alignment - 1);
+
+        // original pointer is kept just before the aligned block, so it can be freed later.
+        auto raw = (char*)::operator new(bytes + Alignment + sizeof(void*));
+        auto aligned = (uintptr_t)(raw + sizeof(void*) + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+        ((void**)aligned)[-1] = raw;
+        return (T*)aligned;
+    }
+
+    void deallocate(T* pointer, size_t) { ::operator delete(((void**)pointer)[-1]); }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const {
+        return false;
+    }
+};
+
+// vector used for storing contiguous component data. Its data() is aligned to componentAlignment bytes.
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+}
@@ -0,0 +1,36 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace EECS;
+
+void* LinearArena::allocate(size_t size, size_t alignment) {
+    while (true) {
+        for (; currentBlock < blocks.size(); currentBlock++, offset = 0) {
+            auto& block = blocks[currentBlock];
+            auto address = (uintptr_t)block.memory.get() + offset;
+            auto padding = (alignment - address % alignment) % alignment;
+
+            if (offset + padding + size <= block.size) {
+                offset += padding + size;
+                usedBytes += padding + size;
+                peakBytes = std::max(peakBytes, usedBytes);
+                return (void*)(address + padding);
+            }
+        }
+
+        auto newBlockSize = std::max(blockSize, size + alignment);
+        blocks.push_back({std::make_unique<char[]>(newBlockSize), newBlockSize});
+        currentBlock = blocks.size() - 1;
+        offset = 0;
+    }
+}
+
+size_t LinearArena::capacity() const {
+    size_t result = 0;
+    for (const auto& block : blocks) {
+        result += block.size;
+    }
+
+    return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <utility>
+#include <new>
+
+namespace EECS {
+
+/** \brief linear(bump) allocator
+*
+* Memory is handed out sequentially from big blocks, and reclaimed all at once by reset(). Blocks are kept after
+* reset, so arena which reached its steady-state size doesn't allocate anymore. Objects created in the arena aren't
+* destroyed by it - owner has to call their destructors, if they are non-trivial, before reset.
+*/
+class LinearArena {
+   public:
+    explicit LinearArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // returns memory for object of given size and alignment. Requests bigger than block size get dedicated block.
+    void* allocate(size_t size, size_t alignment);
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // makes all memory available again, in O(1).
+    void reset() {
+        currentBlock = 0;
+        offset = 0;
+        usedBytes = 0;
+    }
+
+    // number of bytes allocated since last reset, including alignment padding.
+    size_t used() const { return usedBytes; }
+
+    // the most bytes which were used at once, since arena was created.
+    size_t highWaterMark() const { return peakBytes; }
+
+    // number of bytes owned by the arena.
+    size_t capacity() const;
+
+   private:
+    struct Block {
+        std::unique_ptr<char[]> memory;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t currentBlock = 0;
+    size_t offset = 0;
+    size_t usedBytes = 0;
+    size_t peakBytes = 0;
+};
+}
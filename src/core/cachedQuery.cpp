@@ -0,0 +1,144 @@
+#include "cachedQuery.h"
+#include <algorithm>
+
+using namespace EECS;
+
+namespace {
+// measures time of its lifetime and adds it to given duration.
+class MaintenanceTimer {
+   public:
+    explicit MaintenanceTimer(std::chrono::nanoseconds& total)
+        : total(total), start(std::chrono::steady_clock::now()) {}
+    ~MaintenanceTimer() { total += std::chrono::steady_clock::now() - start; }
+
+   private:
+    std::chrono::nanoseconds& total;
+    std::chrono::steady_clock::time_point start;
+};
+}
+
+const std::vector<EntityID>& CachedQueryBase::entities() {
+    std::lock_guard<std::mutex> lock(mutex);
+    update();
+    return matching;
+}
+
+void CachedQueryBase::refreshComponents() {
+    std::lock_guard<std::mutex> lock(mutex);
+    update();
+    if (!componentsValid) {
+        MaintenanceTimer timer(stats.maintenanceTime);
+        cacheComponents(matching);
+        componentsValid = true;
+    }
+}
+
+void CachedQueryBase::update() {
+    if (valid) {
+        stats.hits++;
+        return;
+    }
+
+    stats.misses++;
+    MaintenanceTimer timer(stats.maintenanceTime);
+    matching.clear();
+    collect(matching);
+    std::sort(matching.begin(), matching.end());
+    valid = true;
+    componentsValid = false;
+}
+
+CachedQueryStatistics CachedQueryBase::statistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void CachedQueryBase::entityChanged(EntityID entityID) {
+    std::lock_guard<std::mutex> lock(mutex);
+    componentsValid = false;
+    if (!valid) {
+        return;
+    }
+
+    MaintenanceTimer timer(stats.maintenanceTime);
+    stats.updates++;
+    auto place = std::lower_bound(matching.begin(), matching.end(), entityID);
+    auto present = place != matching.end() && *place == entityID;
+    auto matched = matches(entityID);
+
+    if (matched && !present) {
+        matching.insert(place, entityID);
+    } else if (!matched && present) {
+        matching.erase(place);
+    }
+}
+
+void CachedQueryBase::entitiesChanged(const std::vector<EntityID>& sortedEntities) {
+    std::lock_guard<std::mutex> lock(mutex);
+    componentsValid = componentsValid && sortedEntities.empty();
+    if (!valid || sortedEntities.empty()) {
+        return;
+    }
+
+    MaintenanceTimer timer(stats.maintenanceTime);
+    stats.updates += sortedEntities.size();
+
+    std::vector<EntityID> added;
+    std::vector<EntityID> removed;
+    for (auto entityID : sortedEntities) {
+        auto present = std::binary_search(matching.begin(), matching.end(), entityID);
+        auto matched = matches(entityID);
+        if (matched && !present) {
+            added.push_back(entityID);
+        } else if (!matched && present) {
+            removed.push_back(entityID);
+        }
+    }
+
+    // both lists are sorted, so results are updated in single compaction and single merge
+    auto toRemove = removed.begin();
+    matching.erase(std::remove_if(matching.begin(), matching.end(),
+                                  [&](EntityID entityID) {
+                                      if (toRemove != removed.end() && *toRemove == entityID) {
+                                          toRemove++;
+                                          return true;
+                                      }
+                                      return false;
+                                  }),
+                   matching.end());
+
+    auto oldSize = matching.size();
+    matching.insert(matching.end(), added.begin(), added.end());
+    std::inplace_merge(matching.begin(), matching.begin() + oldSize, matching.end());
+}
+
+void CachedQueryBase::entitiesDestroyed(const std::vector<EntityID>& sortedEntities) {
+    std::lock_guard<std::mutex> lock(mutex);
+    componentsValid = componentsValid && sortedEntities.empty();
+    if (!valid || sortedEntities.empty()) {
+        return;
+    }
+
+    MaintenanceTimer timer(stats.maintenanceTime);
+    auto destroyed = sortedEntities.begin();
+    matching.erase(std::remove_if(matching.begin(), matching.end(),
+                                  [&](EntityID entityID) {
+                                      while (destroyed != sortedEntities.end() && *destroyed < entityID) {
+                                          destroyed++;
+                                      }
+                                      return destroyed != sortedEntities.end() && *destroyed == entityID;
+                                  }),
+                   matching.end());
+}
+
+void CachedQueryBase::componentsMoved() {
+    std::lock_guard<std::mutex> lock(mutex);
+    componentsValid = false;
+}
+
+void CachedQueryBase::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    valid = false;
+    componentsValid = false;
+    matching.clear();
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <mutex>
+#include <chrono>
+#include <utility>
+#include <initializer_list>
+#include "entityID.h"
+#include "componentContainerID.h"
+#include "componentStorage.h"
+#include "componentCursor.h"
+
+namespace EECS {
+// statistics of a CachedQuery, used to check whether caching pays off.
+struct CachedQueryStatistics {
+    // accesses served from up to date results.
+    size_t hits = 0;
+    // accesses which required rebuilding results from scratch.
+    size_t misses = 0;
+    // entities re-checked after their components of one of query's types changed.
+    size_t updates = 0;
+    // time spent on updates and rebuilds.
+    std::chrono::nanoseconds maintenanceTime{0};
+
+    double hitRate() const { return hits + misses ? (double)hits / (hits + misses) : 0.0; }
+};
+
+// Part of CachedQuery which doesn't depend on component types. Keeps sorted ids of matching entities, which are
+// updated by ComponentManager whenever components of query's types are added or deleted.
+class CachedQueryBase {
+   public:
+    virtual ~CachedQueryBase() {}
+
+    // returns ids of entities which have all types of the query, sorted. Results are rebuilt if they were invalidated.
+    // Returned vector is valid until next structural change of query's types.
+    const std::vector<EntityID>& entities();
+
+    size_t size() { return entities().size(); }
+
+    // component types of the query.
+    const ComponentSignature& signature() const { return types; }
+
+    CachedQueryStatistics statistics() const;
+
+   protected:
+    // signatures are used to check entities in O(1). If nullptr, components are looked up.
+    CachedQueryBase(const ComponentSignature& types, const std::vector<ComponentSignature>* signatures)
+        : signatures(signatures), types(types) {}
+
+    const std::vector<ComponentSignature>* signatures;
+
+    // checks if entity has all types of the query.
+    virtual bool matches(EntityID entityID) = 0;
+
+    // appends ids of all matching entities to result, in any order.
+    virtual void collect(std::vector<EntityID>& result) = 0;
+
+    // caches pointers to components of given matching entities, which are sorted.
+    virtual void cacheComponents(const std::vector<EntityID>& matching) = 0;
+
+    // rebuilds results if they were invalidated, and calls cacheComponents if components of query's types could have
+    // moved since it was last called.
+    void refreshComponents();
+
+   private:
+    ComponentSignature types;
+    std::vector<EntityID> matching;
+    bool valid = false;
+    // false if cached pointers may be dangling, as components of query's types were added or deleted.
+    bool componentsValid = false;
+    CachedQueryStatistics stats;
+    mutable std::mutex mutex;
+
+    // re-checks entity whose components of query's types changed.
+    void entityChanged(EntityID entityID);
+
+    // re-checks given entities, which must be sorted and unique.
+    void entitiesChanged(const std::vector<EntityID>& sortedEntities);
+
+    // removes given entities, which must be sorted and unique.
+    void entitiesDestroyed(const std::vector<EntityID>& sortedEntities);
+
+    // drops results, so they are rebuilt on next access.
+    void invalidate();
+
+    // marks cached components as stale, after components of query's types were reordered.
+    void componentsMoved();
+
+    // rebuilds results if they were invalidated. Mutex must be locked.
+    void update();
+
+    friend class ComponentManager;
+};
+
+/** \brief cached result of a query over entities which have at least given component types
+*
+* Obtained from ComponentManager::cachedQuery<Head, Tail...>(), which registers it on first call. Unlike intersection()
+* or View, matching entities are not searched for every time - the set is kept up to date incrementally, as components
+* of query's types are added or deleted, so accessing it costs O(matches).
+*
+* Usage:
+* components.cachedQuery<Transform, AIState>().each([](EntityID entity, Transform& transform, AIState& state) { ... });
+*
+* Pointers to components of matching entities are cached as well, so each() doesn't look anything up. Adding or deleting
+* components of query's types may move other ones, so it marks the pointers as stale, and next each() finds them again
+* with ComponentCursors - in single merge pass over containers sorted by entity id. Components may be modified during
+* each(), but not added or deleted.
+*/
+template <class Head, class... Tail>
+class CachedQuery : public CachedQueryBase {
+    using Indices = std::index_sequence_for<Head, Tail...>;
+
+   public:
+    CachedQuery(const std::vector<ComponentSignature>* signatures, ContainerFor<Head>* headContainer,
+                ContainerFor<Tail>*... tailContainers)
+        : CachedQueryBase(ComponentContainerID::signature<Head, Tail...>(), signatures),
+          containers(headContainer, tailContainers...) {}
+
+    // calls function(EntityID, Head&, Tail&...) for every matching entity, in order of ids.
+    template <class Function>
+    void each(Function&& function) {
+        refreshComponents();
+        for (auto& row : rows) {
+            invoke(function, row, Indices{});
+        }
+    }
+
+   private:
+    // matching entity with pointers to its components.
+    using Row = std::tuple<EntityID, Head*, Tail*...>;
+
+    std::tuple<ContainerFor<Head>*, ContainerFor<Tail>*...> containers;
+    std::vector<Row> rows;
+
+    bool matches(EntityID entityID) override {
+        if (signatures) {
+            auto index = entityIndex(entityID);
+            return index < signatures->size() && (*signatures)[index].containsAll(signature());
+        }
+
+        return findAll(entityID, Indices{});
+    }
+
+    void collect(std::vector<EntityID>& result) override {
+        for (auto& head : std::get<0>(containers)->getAllComponents()) {
+            if (matches(head.entityID)) {
+                result.push_back(head.entityID);
+            }
+        }
+    }
+
+    void cacheComponents(const std::vector<EntityID>& matching) override { cacheRows(matching, Indices{}); }
+
+    template <size_t... ContainerIndices>
+    void cacheRows(const std::vector<EntityID>& matching, std::index_sequence<ContainerIndices...>) {
+        std::tuple<ComponentCursor<ContainerFor<Head>>, ComponentCursor<ContainerFor<Tail>>...> cursors(
+            std::get<ContainerIndices>(containers)...);
+
+        rows.clear();
+        rows.reserve(matching.size());
+        for (auto entityID : matching) {
+            rows.emplace_back(entityID, std::get<ContainerIndices>(cursors).find(entityID)...);
+        }
+    }
+
+    template <size_t... ContainerIndices>
+    bool findAll(EntityID entityID, std::index_sequence<ContainerIndices...>) {
+        bool found = true;
+        (void)std::initializer_list<int>{
+            (found = found && std::get<ContainerIndices>(containers)->getComponent(entityID) != nullptr, 0)...};
+        return found;
+    }
+
+    template <class Function, size_t... ContainerIndices>
+    void invoke(Function& function, const Row& row, std::index_sequence<ContainerIndices...>) {
+        function(std::get<0>(row), *std::get<ContainerIndices + 1>(row)...);
+    }
+};
+}
@@ -0,0 +1,144 @@
+#include "commandBuffer.h"
+#include <algorithm>
+#include "entityManager.h"
+
+using namespace EECS;
+
+CommandBuffer::CommandBuffer() {}
+
+CommandBuffer::~CommandBuffer() { reset(); }
+
+EntityID CommandBuffer::createEntity() {
+    auto entityID = makeEntityID(createdEntities++, deferredEntityGeneration);
+    localRecorder().commands.push_back({CommandType::CreateEntity, entityID, nullptr, nullptr, 0});
+    return entityID;
+}
+
+void CommandBuffer::destroyEntity(EntityID entityID) {
+    localRecorder().commands.push_back({CommandType::DestroyEntity, entityID, nullptr, nullptr, 0});
+}
+
+void CommandBuffer::setParent(EntityID child, EntityID parent) {
+    localRecorder().commands.push_back({CommandType::SetParent, child, nullptr, nullptr, parent});
+}
+
+void CommandBuffer::apply(EntityManager& entities, ComponentManager& components) {
+    apply(std::vector<CommandBuffer*>{this}, entities, components);
+}
+
+void CommandBuffer::apply(const std::vector<CommandBuffer*>& buffers, EntityManager& entities,
+                          ComponentManager& components) {
+    std::vector<Command*> componentCommands;
+    std::vector<Command*> parentCommands;
+    std::vector<EntityID> destroyedEntities;
+
+    // create entities of all buffers and map temporary ids to real ones. Temporary ids of every buffer start from 0,
+    // so ids of given buffer are offset by number of entities created by preceding ones.
+    size_t createdCount = 0;
+    for (auto buffer : buffers) {
+        createdCount += buffer->createdEntities.load();
+    }
+    auto createdIDs = entities.createEntities(createdCount);
+
+    size_t firstCreated = 0;
+    for (auto buffer : buffers) {
+        auto resolve = [&createdIDs, firstCreated](EntityID entityID) {
+            return isDeferredEntity(entityID) ? createdIDs[firstCreated + entityIndex(entityID)] : entityID;
+        };
+
+        for (auto& recorder : buffer->recorders) {
+            for (auto& command : recorder->commands) {
+                command.entity = resolve(command.entity);
+
+                if (command.type == CommandType::DestroyEntity) {
+                    destroyedEntities.push_back(command.entity);
+                } else if (command.type == CommandType::SetParent) {
+                    command.parent = resolve(command.parent);
+                    parentCommands.push_back(&command);
+                } else if (command.type != CommandType::CreateEntity) {
+                    componentCommands.push_back(&command);
+                }
+            }
+        }
+
+        firstCreated += buffer->createdEntities.load();
+    }
+
+    // stable sort keeps order of recording(and of buffers) for commands concerning the same component of the same
+    // entity
+    std::stable_sort(componentCommands.begin(), componentCommands.end(), [](const Command* a, const Command* b) {
+        return a->operations->componentID != b->operations->componentID
+                   ? a->operations->componentID < b->operations->componentID
+                   : a->entity < b->entity;
+    });
+
+    std::vector<Command*> adds;
+    std::vector<EntityID> deletes;
+    for (size_t i = 0; i < componentCommands.size();) {
+        auto operations = componentCommands[i]->operations;
+        adds.clear();
+        deletes.clear();
+
+        for (; i < componentCommands.size() && componentCommands[i]->operations == operations; i++) {
+            auto& command = *componentCommands[i];
+            auto lastForEntity =
+                i + 1 == componentCommands.size() || componentCommands[i + 1]->operations != operations ||
+                componentCommands[i + 1]->entity != command.entity;
+
+            if (!lastForEntity || !entities.entityExists(command.entity)) {
+                continue;
+            }
+
+            if (command.type == CommandType::AddComponent) {
+                adds.push_back(&command);
+            } else {
+                deletes.push_back(command.entity);
+            }
+        }
+
+        operations->apply(components, adds, deletes);
+    }
+
+    for (auto command : parentCommands) {
+        entities.setParent(command->entity, command->parent);
+    }
+
+    entities.destroyEntities(std::move(destroyedEntities));
+    for (auto buffer : buffers) {
+        buffer->reset();
+    }
+}
+
+void CommandBuffer::clear() { reset(); }
+
+bool CommandBuffer::empty() const {
+    std::lock_guard<std::mutex> lock(recordersMutex);
+    return std::all_of(recorders.begin(), recorders.end(),
+                       [](const std::unique_ptr<Recorder>& recorder) { return recorder->commands.empty(); });
+}
+
+CommandBuffer::Recorder& CommandBuffer::localRecorder() {
+    if (auto recorder = threadRecorders.find()) {
+        return *static_cast<Recorder*>(recorder);
+    }
+
+    std::lock_guard<std::mutex> lock(recordersMutex);
+    recorders.push_back(std::make_unique<Recorder>());
+    threadRecorders.add(recorders.back().get());
+    return *recorders.back();
+}
+
+void CommandBuffer::reset() {
+    for (auto& recorder : recorders) {
+        for (auto& command : recorder->commands) {
+            if (command.type == CommandType::AddComponent) {
+                command.operations->destroy(command.component);
+            }
+        }
+
+        recorder->commands.clear();
+        recorder->arena.reset();
+    }
+
+    createdEntities = 0;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include "arena.h"
+#include "threadLocalSlots.h"
+#include "entityID.h"
+#include "componentContainerID.h"
+#include "componentManager.h"
+
+namespace EECS {
+class EntityManager;
+
+/** \brief records structural changes(creating/destroying entities, adding/deleting components) to apply them later
+*
+* Adding or deleting components invalidates pointers and iterators of containers, so it can't be done while they are
+* iterated, or while other Tasks are updated concurrently. CommandBuffer collects such changes, and applies them all
+* at once at a safe point. Every Task has its own buffer(TaskBase::commands). TaskScheduler applies buffers of all
+* Tasks due in current update together, after they are done.
+*
+* Recording is thread-safe and contention-free: each thread records to its own arena, so workers spawned by a Task
+* (for ex. in ComponentManager::parallelForEach) can share Task's buffer.
+*
+* Entities created by the buffer get temporary ids(see isDeferredEntity), which can be used in further commands
+* recorded in the same buffer. They are replaced with real ids when the buffer is applied.
+*
+* Applying is done in single batched pass: entities are created first, then component commands are sorted by
+* component type and entity and applied with one merge/compaction per container, then parents are set, and finally
+* entities are destroyed.
+* If entity has several commands for the same component type, only the last one matters.
+*/
+class CommandBuffer {
+   public:
+    CommandBuffer();
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // records creation of an entity, returns its temporary id.
+    EntityID createEntity();
+
+    // records deletion of an entity with all its components.
+    void destroyEntity(EntityID entityID);
+
+    // records adding component to entity. Component is constructed immediately, from given arguments.
+    template <class T, class... Args>
+    void addComponent(EntityID entityID, Args&&... args) {
+        static_assert(std::is_base_of<Component<T>, T>::value, "T must be a component type!");
+        auto& recorder = localRecorder();
+        auto component = recorder.arena.create<T>(std::forward<Args>(args)...);
+        recorder.commands.push_back({CommandType::AddComponent, entityID, &ComponentOperations::of<T>(), component, 0});
+    }
+
+    // records making parent the parent of child(see EntityManager::setParent). Both can be temporary ids.
+    void setParent(EntityID child, EntityID parent);
+
+    // records deletion of component owned by entity.
+    template <class T>
+    void deleteComponent(EntityID entityID) {
+        static_assert(std::is_base_of<Component<T>, T>::value, "T must be a component type!");
+        localRecorder().commands.push_back(
+            {CommandType::DeleteComponent, entityID, &ComponentOperations::of<T>(), nullptr, 0});
+    }
+
+    // applies all recorded commands and clears the buffer. Commands concerning non-existent entities are skipped.
+    // Must not be called concurrently with recording.
+    void apply(EntityManager& entities, ComponentManager& components);
+
+    // applies commands of all given buffers in single batched pass, and clears them. The result is the same as
+    // applying them one by one in given order, but every container is merged at most once.
+    static void apply(const std::vector<CommandBuffer*>& buffers, EntityManager& entities,
+                      ComponentManager& components);
+
+    // discards all recorded commands.
+    void clear();
+
+    bool empty() const;
+
+   private:
+    enum class CommandType { CreateEntity, DestroyEntity, AddComponent, DeleteComponent, SetParent };
+
+    struct Command;
+
+    // operations on components of particular type, which don't require knowing this type.
+    struct ComponentOperations {
+        size_t componentID;
+
+        // moves components from add commands into container and deletes components of given entities. Add commands
+        // are sorted by entity and belong to unique, existing entities.
+        void (*apply)(ComponentManager& components, std::vector<Command*>& adds, std::vector<EntityID>& deletes);
+        void (*destroy)(void* component);
+
+        template <class T>
+        static const ComponentOperations& of() {
+            static const ComponentOperations operations{ComponentContainerID::get<T>(), &applyCommands<T>,
+                                                        [](void* component) { ((T*)component)->~T(); }};
+            return operations;
+        }
+
+        template <class T>
+        static void applyCommands(ComponentManager& components, std::vector<Command*>& adds,
+                                  std::vector<EntityID>& deletes) {
+            auto container = components.getContainer<T>(true);
+
+            std::vector<T> newComponents;
+            std::vector<EntityID> addedEntities;
+            newComponents.reserve(adds.size());
+            addedEntities.reserve(adds.size());
+            for (auto command : adds) {
+                newComponents.push_back(std::move(*(T*)command->component));
+                newComponents.back().entityID = command->entity;
+                addedEntities.push_back(command->entity);
+            }
+
+            container->insertComponents(newComponents);
+            container->genericDeleteComponents(deletes);
+
+            components.componentsChanged(addedEntities, ComponentContainerID::get<T>(), true);
+            components.componentsChanged(deletes, ComponentContainerID::get<T>(), false);
+        }
+    };
+
+    struct Command {
+        CommandType type;
+        EntityID entity;
+        const ComponentOperations* operations;
+        void* component;
+        // parent of entity, for SetParent commands.
+        EntityID parent;
+    };
+
+    // commands recorded by single thread.
+    struct Recorder {
+        LinearArena arena;
+        std::vector<Command> commands;
+    };
+
+    // finds recorder of calling thread.
+    ThreadLocalSlots threadRecorders;
+
+    mutable std::mutex recordersMutex;
+    std::vector<std::unique_ptr<Recorder>> recorders;
+    std::atomic<uint32_t> createdEntities{0};
+
+    Recorder& localRecorder();
+
+    // destroys components owned by commands and resets recorders.
+    void reset();
+};
+}
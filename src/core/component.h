@@ -1,6 +1,8 @@
 #pragma once
 #include <unordered_map>
+#include <cassert>
 #include "componentContainerID.h"
+#include "componentStorage.h"
 #include "globalDefs.h"
 #include "entityID.h"
 
@@ -11,12 +13,19 @@ template <typename T>
 class ComponentRegistrator {
    public:
     ComponentRegistrator() {
+        // throws if there are too many component types, so registration fails at startup in every build
         auto id = ComponentContainerID::get<T>();
+        assert(id < maxComponentTypes && "Too many component types, increase maxComponentTypes!");
 
         if (singleComponentContainerArchetypes().size() <= id) {
             singleComponentContainerArchetypes().resize(id + 1);
         }
-        singleComponentContainerArchetypes()[id] = std::make_unique<ComponentContainer<T>>();
+        singleComponentContainerArchetypes()[id] = std::make_unique<ContainerFor<T>>();
+
+        if (changeTrackingComponentTypes().size() <= id) {
+            changeTrackingComponentTypes().resize(id + 1);
+        }
+        changeTrackingComponentTypes()[id] = T::trackChanges;
     }
 };
 
@@ -40,9 +49,20 @@ class ComponentRegistrator {
 *   }
 * };
 *
+* By default components are stored in vector sorted by entity id(SortedStorage), and tag components, which have no
+* members(like `struct Enemy : Component<Enemy> {};`), are stored in sparse sets(TagStorage). Component type
+* can choose other storage policy by declaring Storage alias, for ex. `using Storage = SparseStorage;`. See
+* componentStorage.h.
+*
+* Component type can declare `static constexpr bool trackChanges = true;` to have ComponentManager record when its
+* components are added, changed and removed. See ComponentManager::changed.
+*
 */
 template <typename Derived>
 struct Component {
+    using Storage = DefaultStorage;
+    static constexpr bool trackChanges = false;
+
     EntityID entityID;
 
    private:
@@ -0,0 +1,123 @@
+#include "componentAccess.h"
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <atomic>
+#include "utils/logger.h"
+#include "utils/loggerConsoleOutput.h"
+
+using namespace EECS;
+
+namespace {
+thread_local const ComponentAccess* currentAccess = nullptr;
+thread_local const char* currentTaskName = nullptr;
+
+std::atomic<size_t> violations{0};
+
+bool intersects(const std::vector<size_t>& first, const std::vector<size_t>& second) {
+    auto firstIt = first.begin();
+    auto secondIt = second.begin();
+
+    while (firstIt != first.end() && secondIt != second.end()) {
+        if (*firstIt == *secondIt) {
+            return true;
+        }
+
+        if (*firstIt < *secondIt) {
+            firstIt++;
+        } else {
+            secondIt++;
+        }
+    }
+
+    return false;
+}
+}
+
+bool ComponentAccess::conflictsWith(const ComponentAccess& other) const {
+    if (!declared || !other.declared) {
+        return true;
+    }
+
+    return intersects(writes, other.writes) || intersects(writes, other.reads) || intersects(reads, other.writes) ||
+           intersects(resourceWrites, other.resourceWrites) || intersects(resourceWrites, other.resourceReads) ||
+           intersects(resourceReads, other.resourceWrites);
+}
+
+bool ComponentAccess::canRead(size_t componentID) const {
+    return std::binary_search(reads.begin(), reads.end(), componentID) || canWrite(componentID);
+}
+
+bool ComponentAccess::canWrite(size_t componentID) const {
+    return std::binary_search(writes.begin(), writes.end(), componentID);
+}
+
+bool ComponentAccess::canReadResource(size_t resourceID) const {
+    return std::binary_search(resourceReads.begin(), resourceReads.end(), resourceID) || canWriteResource(resourceID);
+}
+
+bool ComponentAccess::canWriteResource(size_t resourceID) const {
+    return std::binary_search(resourceWrites.begin(), resourceWrites.end(), resourceID);
+}
+
+ComponentAccess::Scope::Scope(const ComponentAccess& access, const char* taskName)
+    : previousAccess(currentAccess), previousTaskName(currentTaskName) {
+    currentAccess = &access;
+    currentTaskName = taskName;
+}
+
+ComponentAccess::Scope::~Scope() {
+    currentAccess = previousAccess;
+    currentTaskName = previousTaskName;
+}
+
+void ComponentAccess::validate(size_t componentID, bool write) {
+    if (!currentAccess || !currentAccess->declared) {
+        return;
+    }
+
+    auto allowed = write ? currentAccess->canWrite(componentID) : currentAccess->canRead(componentID);
+    if (!allowed) {
+        reportViolation("component", componentID, write);
+    }
+}
+
+void ComponentAccess::validateResource(size_t resourceID, bool write) {
+    if (!currentAccess || !currentAccess->declared) {
+        return;
+    }
+
+    auto allowed = write ? currentAccess->canWriteResource(resourceID) : currentAccess->canReadResource(resourceID);
+    if (!allowed) {
+        reportViolation("resource", resourceID, write);
+    }
+}
+
+void ComponentAccess::reportViolation(const char* kind, size_t id, bool write) {
+    violations++;
+
+    // every distinct violation is reported once, as it usually happens every update
+    static std::mutex reportedMutex;
+    static std::set<std::tuple<const char*, const char*, size_t>> reported;
+    static Logger logger = [] {
+        Logger logger("TASKS");
+        logger.addOutput(std::make_shared<ConsoleOutput>());
+        return logger;
+    }();
+
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    if (reported.insert(std::make_tuple(currentTaskName, kind, id * 2 + write)).second) {
+        logger.error("Task ", currentTaskName, (write ? " writes " : " reads "), kind, " type ", (unsigned long long)id,
+                     " without declaring it. It may run concurrently with Tasks which modify it.");
+    }
+}
+
+size_t ComponentAccess::violationCount() { return violations.load(); }
+
+void ComponentAccess::normalize() {
+    for (auto set : {&reads, &writes, &resourceReads, &resourceWrites}) {
+        std::sort(set->begin(), set->end());
+        set->erase(std::unique(set->begin(), set->end()), set->end());
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+#include <initializer_list>
+#include "componentContainerID.h"
+#include "component.h"
+
+namespace EECS {
+
+// Declares component and resource types which Task reads, for ex. Task<Renderer, Reads<Position, Sprite, Camera>>.
+template <class... Types>
+struct Reads {};
+
+// Declares component and resource types which Task modifies(adds, deletes or changes), for ex.
+// Task<Physics, Writes<Position>>. Writing implies reading.
+template <class... Types>
+struct Writes {};
+
+/** \brief set of component and resource types which given Task reads and writes
+*
+* Used by TaskScheduler to find out which Tasks can be updated concurrently: two Tasks conflict if one of them
+* writes component or resource type which the other one reads or writes. Task which doesn't declare its access at all
+* conflicts with every other Task, so it's always updated alone.
+*
+* Types deriving from Component are declared as components, all other ones as resources(see Resources).
+*
+* In debug builds, ComponentManager and Resources check every access made during Task update against its declaration,
+* and report undeclared ones.
+*/
+class ComponentAccess {
+   public:
+    template <class... Declarations>
+    static ComponentAccess of() {
+        ComponentAccess access;
+        access.declared = sizeof...(Declarations) > 0;
+        (void)std::initializer_list<int>{(Declaration<Declarations>::addTo(access), 0)...};
+        access.normalize();
+        return access;
+    }
+
+    bool conflictsWith(const ComponentAccess& other) const;
+
+    bool canRead(size_t componentID) const;
+    bool canWrite(size_t componentID) const;
+
+    bool canReadResource(size_t resourceID) const;
+    bool canWriteResource(size_t resourceID) const;
+
+    bool isDeclared() const { return declared; }
+
+    // Makes given access the one against which accesses made by the calling thread are validated, until destruction.
+    class Scope {
+       public:
+        Scope(const ComponentAccess& access, const char* taskName);
+        ~Scope();
+
+       private:
+        const ComponentAccess* previousAccess;
+        const char* previousTaskName;
+    };
+
+    // reports access to component which isn't declared by Task currently updated on this thread. Called only in debug
+    // builds.
+    static void validate(size_t componentID, bool write);
+
+    // the same as validate, but for resource type.
+    static void validateResource(size_t resourceID, bool write);
+
+    // number of undeclared accesses reported so far.
+    static size_t violationCount();
+
+   private:
+    std::vector<size_t> reads;
+    std::vector<size_t> writes;
+    std::vector<size_t> resourceReads;
+    std::vector<size_t> resourceWrites;
+    bool declared = false;
+
+    template <class T>
+    struct Declaration;
+
+    template <class... Types>
+    struct Declaration<Reads<Types...>> {
+        static void addTo(ComponentAccess& access) {
+            (void)std::initializer_list<int>{(access.add<Types>(access.reads, access.resourceReads), 0)...};
+        }
+    };
+
+    template <class... Types>
+    struct Declaration<Writes<Types...>> {
+        static void addTo(ComponentAccess& access) {
+            (void)std::initializer_list<int>{(access.add<Types>(access.writes, access.resourceWrites), 0)...};
+        }
+    };
+
+    template <class T>
+    void add(std::vector<size_t>& components, std::vector<size_t>& resources) {
+        using Type = std::remove_cv_t<T>;
+        add<Type>(components, resources, std::is_base_of<Component<Type>, Type>{});
+    }
+
+    template <class T>
+    void add(std::vector<size_t>& components, std::vector<size_t>&, std::true_type) {
+        components.push_back(ComponentContainerID::get<T>());
+    }
+
+    template <class T>
+    void add(std::vector<size_t>&, std::vector<size_t>& resources, std::false_type) {
+        resources.push_back(ResourceID::get<T>());
+    }
+
+    // reports undeclared access of Task currently updated on this thread to given component or resource type.
+    static void reportViolation(const char* kind, size_t id, bool write);
+
+    // sorts and removes duplicates, so sets can be intersected linearly.
+    void normalize();
+};
+}
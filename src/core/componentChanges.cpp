@@ -0,0 +1,87 @@
+#include "componentChanges.h"
+#include <algorithm>
+
+using namespace EECS;
+
+void ComponentChanges::add(EntityID entityID, uint64_t tick) {
+    auto index = entityIndex(entityID);
+    if (index >= entries.size()) {
+        entries.resize(index + 1);
+    }
+
+    auto& entry = entries[index];
+    if (entry.entityID != entityID) {
+        entry.entityID = entityID;
+        entry.added = tick;
+    }
+    entry.changed = tick;
+}
+
+void ComponentChanges::change(EntityID entityID, uint64_t tick) {
+    if (auto entry = find(entityID)) {
+        entry->changed = tick;
+    }
+}
+
+void ComponentChanges::remove(EntityID entityID, uint64_t tick) {
+    if (auto entry = find(entityID)) {
+        *entry = Entry();
+        removals.emplace_back(entityID, tick);
+    }
+}
+
+void ComponentChanges::removeAll(uint64_t tick) {
+    for (auto& entry : entries) {
+        if (entry.entityID) {
+            removals.emplace_back(entry.entityID, tick);
+            entry = Entry();
+        }
+    }
+}
+
+std::vector<EntityID> ComponentChanges::addedSince(uint64_t tick) const {
+    std::vector<EntityID> result;
+    for (const auto& entry : entries) {
+        if (entry.entityID && entry.added > tick) {
+            result.push_back(entry.entityID);
+        }
+    }
+
+    return result;
+}
+
+std::vector<EntityID> ComponentChanges::changedSince(uint64_t tick) const {
+    std::vector<EntityID> result;
+    for (const auto& entry : entries) {
+        if (entry.entityID && entry.changed > tick) {
+            result.push_back(entry.entityID);
+        }
+    }
+
+    return result;
+}
+
+std::vector<EntityID> ComponentChanges::removedSince(uint64_t tick) const {
+    std::vector<EntityID> result;
+    for (const auto& removal : removals) {
+        if (removal.second > tick) {
+            result.push_back(removal.first);
+        }
+    }
+
+    return result;
+}
+
+void ComponentChanges::discardUntil(uint64_t tick) {
+    auto discarded = [tick](const std::pair<EntityID, uint64_t>& removal) { return removal.second <= tick; };
+    removals.erase(std::remove_if(removals.begin(), removals.end(), discarded), removals.end());
+}
+
+ComponentChanges::Entry* ComponentChanges::find(EntityID entityID) {
+    auto index = entityIndex(entityID);
+    if (index >= entries.size() || entries[index].entityID != entityID) {
+        return nullptr;
+    }
+
+    return &entries[index];
+}
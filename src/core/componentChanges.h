@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "entityID.h"
+
+namespace EECS {
+/** \brief records when components of single type were added, changed and removed
+*
+* Used by ComponentManager for component types which declare `static constexpr bool trackChanges = true;`. Every
+* change is stamped with tick(see ComponentManager::tick), so code which remembers tick of its previous run can
+* process only components changed since then.
+*
+* Ticks of added and changed components are kept per entity, in array indexed by entity index. Removals are logged,
+* as removed components don't exist anymore - log is trimmed by discardUntil.
+*/
+class ComponentChanges {
+   public:
+    // records that component of given entity was added, or replaced - then it counts as changed.
+    void add(EntityID entityID, uint64_t tick);
+
+    // records that component of given entity was changed. Ignored if entity doesn't have the component. Can be
+    // called concurrently for different entities.
+    void change(EntityID entityID, uint64_t tick);
+
+    // records that component of given entity was removed. Ignored if entity doesn't have the component.
+    void remove(EntityID entityID, uint64_t tick);
+
+    // records that all components were removed.
+    void removeAll(uint64_t tick);
+
+    // returns entities whose components were added after given tick, in order of entity indices.
+    std::vector<EntityID> addedSince(uint64_t tick) const;
+
+    // returns entities whose components were added or changed after given tick, in order of entity indices.
+    std::vector<EntityID> changedSince(uint64_t tick) const;
+
+    // returns entities whose components were removed after given tick, in order of removal. Entity may be reported
+    // more than once, if component was removed several times.
+    std::vector<EntityID> removedSince(uint64_t tick) const;
+
+    // forgets removals stamped with given tick or earlier.
+    void discardUntil(uint64_t tick);
+
+   private:
+    struct Entry {
+        // 0 if entity with this index doesn't have the component.
+        EntityID entityID = 0;
+        uint64_t added = 0;
+        uint64_t changed = 0;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::pair<EntityID, uint64_t>> removals;
+
+    // returns entry of given entity, or nullptr if it doesn't have the component.
+    Entry* find(EntityID entityID);
+};
+}
@@ -2,6 +2,8 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <functional>
+#include "alignedAllocator.h"
 #include "entityID.h"
 
 namespace EECS {
@@ -16,6 +18,10 @@ class ComponentContainerBase {
 
     virtual bool cloneComponent(EntityID sourceEntity, EntityID recipientEntity) = 0;
     virtual bool genericDeleteComponent(EntityID entity) = 0;
+
+    // deletes components of all given entities at once. Entities must be sorted and unique. Returns number of deleted
+    // components.
+    virtual size_t genericDeleteComponents(const std::vector<EntityID>& sortedEntities) = 0;
 };
 
 // Template class used for storing components of particular type.
@@ -39,8 +45,9 @@ class ComponentContainer : public ComponentContainerBase {
     // the vector in any way, otherwise class invariants could be invalidated. It's not const vector because then
     // modifying components itself would be impossible, which would render this method useless. If user wants to
     // batch process every/most of components, it's much faster than getting them one by one with getComponent. If user
-    // don't know exact entity id, then it's only viable method to do so.
-    std::vector<T>& getAllComponents() { return components; }
+    // don't know exact entity id, then it's only viable method to do so. Data of the vector is aligned to
+    // componentAlignment bytes, see ComponentManager::forEachChunk.
+    AlignedVector<T>& getAllComponents() { return components; }
 
     // adds new component, replaces existing component if already exists. Arguments after EntityID will be passed
     // directly to component's constructor. Returns pointer to created component.
@@ -65,6 +72,47 @@ class ComponentContainer : public ComponentContainerBase {
         return &*place;
     }
 
+    // adds components to all given entities, in single merge pass. Entities must be sorted, unique and non-null.
+    // Each component is constructed from args, which are passed by const reference, as they are reused. Existing
+    // components are replaced.
+    template <typename... Args>
+    void addComponents(const std::vector<EntityID>& sortedEntities, const Args&... args) {
+        std::vector<T> newComponents;
+        newComponents.reserve(sortedEntities.size());
+        for (auto entityID : sortedEntities) {
+            newComponents.push_back(T(args...));
+            newComponents.back().entityID = entityID;
+        }
+
+        insertComponents(newComponents);
+    }
+
+    // moves given components into container, in single merge pass. Components must be sorted by entityID, and belong
+    // to unique, non-null entities. Existing components are replaced.
+    void insertComponents(std::vector<T>& sortedComponents) {
+        auto oldSize = components.size();
+        auto existing = components.begin();
+
+        for (auto& component : sortedComponents) {
+            existing =
+                std::lower_bound(existing, components.begin() + oldSize, component.entityID,
+                                 [](const T& component, EntityID entityID) { return component.entityID < entityID; });
+
+            if (existing != components.begin() + oldSize && existing->entityID == component.entityID) {
+                *existing = std::move(component);
+            } else {
+                // may reallocate, so position of search is restored afterwards
+                auto searchPosition = existing - components.begin();
+                components.push_back(std::move(component));
+                existing = components.begin() + searchPosition;
+            }
+        }
+
+        // both ranges are sorted, so merging them keeps container sorted
+        std::inplace_merge(components.begin(), components.begin() + oldSize, components.end(),
+                           [](const T& first, const T& second) { return first.entityID < second.entityID; });
+    }
+
     // copies component from one entity to another. Returns true if component was cloned, otherwise false.
     bool cloneComponent(EntityID sourceEntity, EntityID recipientEntity) override {
         auto sourceComponent = getComponent(sourceEntity);
@@ -72,15 +120,8 @@ class ComponentContainer : public ComponentContainerBase {
             return false;
         }
 
-        auto targetComponent = addComponent(recipientEntity);
-        if (!targetComponent) {
-            return false;
-        }
-
-        *targetComponent = *sourceComponent;
-        targetComponent->entityID = recipientEntity;
-
-        return true;
+        // copy is constructed before insertion, which may relocate the source component.
+        return addComponent(recipientEntity, *sourceComponent) != nullptr;
     }
 
     // Deletes component of a given Entity. Returns true if deleted, false if it doesn't exist in the first place.
@@ -97,9 +138,39 @@ class ComponentContainer : public ComponentContainerBase {
         return false;
     }
 
+    // checks if pointer obtained from this container still points to component of given entity, in O(1). Pointers
+    // can be invalidated by adding or deleting any component of this type, as the vector moves its elements.
+    bool validPointer(const T* componentPtr, EntityID entityID) const {
+        return !components.empty() && !std::less<const T*>()(componentPtr, &components.front()) &&
+               !std::less<const T*>()(&components.back(), componentPtr) && componentPtr->entityID == entityID;
+    }
+
     // used internally as a method to delete all components from given entity.
     bool genericDeleteComponent(EntityID entityID) override { return deleteComponent(entityID); }
 
+    // deletes components of given entities in single compaction pass, in O(n + k).
+    size_t genericDeleteComponents(const std::vector<EntityID>& sortedEntities) override {
+        if (sortedEntities.empty()) {
+            return 0;
+        }
+
+        auto first =
+            std::lower_bound(components.begin(), components.end(), sortedEntities.front(),
+                             [](const T& component, EntityID entityID) { return component.entityID < entityID; });
+
+        auto toDelete = sortedEntities.begin();
+        auto kept = std::remove_if(first, components.end(), [&](const T& component) {
+            while (toDelete != sortedEntities.end() && *toDelete < component.entityID) {
+                toDelete++;
+            }
+            return toDelete != sortedEntities.end() && *toDelete == component.entityID;
+        });
+
+        auto deleted = (size_t)(components.end() - kept);
+        components.erase(kept, components.end());
+        return deleted;
+    }
+
     // Deletes all components
     void clear() override { components.clear(); }
 
@@ -109,6 +180,6 @@ class ComponentContainer : public ComponentContainerBase {
     }
 
    private:
-    std::vector<T> components;
+    AlignedVector<T> components;
 };
 }
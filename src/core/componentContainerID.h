@@ -1,15 +1,162 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <initializer_list>
+#include <type_traits>
+#include <stdexcept>
 
 namespace EECS {
+// upper limit of number of component types. Signatures of entities have fixed size, so it can't be exceeded - id of
+// component type beyond it throws std::length_error, in every build.
+constexpr size_t maxComponentTypes = 128;
+
+/** \brief set of component types, indexed by ComponentContainerID
+*
+* Used like std::bitset<maxComponentTypes>, but its words are atomic. Tasks which write different component types can
+* add or delete components of the same entity concurrently, each of them changing only its own bit in entity's
+* signature, so bits are changed with atomic fetch_or/fetch_and and concurrent updates aren't lost. Other operations
+* use relaxed loads and stores - signature read while it's changed has either old or new state of every bit.
+*/
+class ComponentSignature {
+   public:
+    ComponentSignature() { reset(); }
+    ComponentSignature(const ComponentSignature& other) { *this = other; }
+
+    ComponentSignature& operator=(const ComponentSignature& other) {
+        for (size_t i = 0; i < wordCount; i++) {
+            words[i].store(other.word(i), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    bool test(size_t index) const { return (word(index / wordBits) & bit(index)) != 0; }
+
+    ComponentSignature& set(size_t index, bool value = true) {
+        auto& target = words[index / wordBits];
+        value ? target.fetch_or(bit(index), std::memory_order_relaxed)
+              : target.fetch_and(~bit(index), std::memory_order_relaxed);
+        return *this;
+    }
+
+    ComponentSignature& reset(size_t index) { return set(index, false); }
+
+    ComponentSignature& reset() {
+        for (auto& target : words) {
+            target.store(0, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    bool any() const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if (word(i) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool none() const { return !any(); }
+
+    // checks if all types of other signature are in this one, without materializing the intersection.
+    bool containsAll(const ComponentSignature& other) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if ((word(i) & other.word(i)) != other.word(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // checks if any type of other signature is in this one.
+    bool containsAny(const ComponentSignature& other) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if ((word(i) & other.word(i)) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ComponentSignature operator&(const ComponentSignature& other) const {
+        ComponentSignature result;
+        for (size_t i = 0; i < wordCount; i++) {
+            result.words[i].store(word(i) & other.word(i), std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    bool operator==(const ComponentSignature& other) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if (word(i) != other.word(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const ComponentSignature& other) const { return !(*this == other); }
+
+   private:
+    static constexpr size_t wordBits = 64;
+    static constexpr size_t wordCount = (maxComponentTypes + wordBits - 1) / wordBits;
+
+    std::atomic<uint64_t> words[wordCount];
+
+    uint64_t word(size_t index) const { return words[index].load(std::memory_order_relaxed); }
+    static uint64_t bit(size_t index) { return uint64_t(1) << (index % wordBits); }
+};
+
 class ComponentContainerID {
    public:
+    // const-qualified type has the same id as the type itself, it only declares read-only access(see ComponentManager).
     template <typename T>
-    static size_t get() {
-        static size_t id = counter++;
+    static size_t get() { return idOf<std::remove_cv_t<T>>(); }
+
+    // returns signature consisting of given component types.
+    template <typename... Types>
+    static ComponentSignature signature() {
+        ComponentSignature result;
+        (void)std::initializer_list<int>{(result.set(get<Types>()), 0)...};
+        return result;
+    }
+
+   private:
+    static size_t counter;
+
+    template <typename T>
+    static size_t idOf() {
+        static size_t id = checked(counter++);
+        return id;
+    }
+
+    // ids are assigned once per type, so it's checked only when id is assigned.
+    static size_t checked(size_t id) {
+        if (id >= maxComponentTypes) {
+            throw std::length_error("Too many component types, increase maxComponentTypes!");
+        }
         return id;
     }
+};
+
+// upper limit of number of resource types(see Resources). Storage of resources has fixed size, so it never
+// reallocates while Tasks access it concurrently.
+constexpr size_t maxResourceTypes = 64;
+
+class ResourceID {
+   public:
+    // const-qualified type has the same id as the type itself, like in ComponentContainerID.
+    template <typename T>
+    static size_t get() { return idOf<std::remove_cv_t<T>>(); }
 
    private:
     static size_t counter;
+
+    template <typename T>
+    static size_t idOf() {
+        static size_t id = counter++;
+        return id;
+    }
 };
 }
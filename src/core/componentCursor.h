@@ -0,0 +1,59 @@
+#pragma once
+#include <algorithm>
+#include "componentContainer.h"
+#include "entityID.h"
+
+namespace EECS {
+// Finds components of consecutive entities in a container. By default components are just looked up.
+template <class Container>
+class ComponentCursor {
+   public:
+    explicit ComponentCursor(Container* container) : container(container) {}
+
+    auto find(EntityID entityID) { return container->getComponent(entityID); }
+
+   private:
+    Container* container;
+};
+
+// Components in ComponentContainer are sorted by entity id, so when ids are increasing, each one is searched for
+// starting from where previous one was found, with exponentially growing steps(galloping). Driving it with sorted ids
+// turns intersection into merge-join: k searches cost O(k lg(n / k)), instead of O(k lg n). Decreasing id restarts
+// search from the beginning.
+template <class T>
+class ComponentCursor<ComponentContainer<T>> {
+   public:
+    explicit ComponentCursor(ComponentContainer<T>* container) : components(container->getAllComponents()) {}
+
+    T* find(EntityID entityID) {
+        if (entityID < previousID) {
+            position = 0;
+        }
+        previousID = entityID;
+
+        // elements before low are known to belong to smaller ids, element at high(if exists) - to not smaller
+        auto low = position, high = position;
+        for (size_t step = 1; high < components.size() && components[high].entityID < entityID; step *= 2) {
+            low = high + 1;
+            high += step;
+        }
+
+        position = std::lower_bound(components.begin() + low, components.begin() + std::min(high, components.size()),
+                                    entityID, [](const T& component, EntityID entityID) {
+                                        return component.entityID < entityID;
+                                    }) -
+                   components.begin();
+
+        if (position == components.size() || components[position].entityID != entityID) {
+            return nullptr;
+        }
+
+        return &components[position];
+    }
+
+   private:
+    AlignedVector<T>& components;
+    size_t position = 0;
+    EntityID previousID = 0;
+};
+}
@@ -3,7 +3,12 @@
 
 using namespace EECS;
 
-void ComponentManager::setEntityManager(const EntityManager& entityManager) { this->entityManager = &entityManager; }
+constexpr size_t ComponentManager::minElementsPerChunk;
+
+void ComponentManager::setEntityManager(EntityManager& entityManager) {
+    this->entityManager = &entityManager;
+    signatures = &entityManager.signatures;
+}
 
 bool ComponentManager::entityExists(EntityID entity) {
     if (entityManager) {
@@ -12,3 +17,91 @@ bool ComponentManager::entityExists(EntityID entity) {
 
     return true;  // no checking if entity manager isn't set
 }
+
+void ComponentManager::discardChangesUntil(uint64_t tick) {
+    for (auto& typeChanges : changes) {
+        if (typeChanges) {
+            typeChanges->discardUntil(tick);
+        }
+    }
+}
+
+void ComponentManager::componentChanged(EntityID entityID, size_t typeID, bool owned) {
+    if (entityManager) {
+        entityManager->setComponentBit(entityID, typeID, owned);
+    }
+
+    for (auto query : queriesByType[typeID]) {
+        query->entityChanged(entityID);
+    }
+
+    if (changes[typeID]) {
+        owned ? changes[typeID]->add(entityID, tick()) : changes[typeID]->remove(entityID, tick());
+    }
+}
+
+void ComponentManager::componentsChanged(const std::vector<EntityID>& entities, size_t typeID, bool owned) {
+    if (entityManager) {
+        for (auto entityID : entities) {
+            entityManager->setComponentBit(entityID, typeID, owned);
+        }
+    }
+
+    for (auto query : queriesByType[typeID]) {
+        query->entitiesChanged(entities);
+    }
+
+    if (changes[typeID]) {
+        for (auto entityID : entities) {
+            owned ? changes[typeID]->add(entityID, tick()) : changes[typeID]->remove(entityID, tick());
+        }
+    }
+}
+
+void ComponentManager::componentsCleared(size_t typeID) {
+    if (entityManager) {
+        for (auto& signature : entityManager->signatures) {
+            signature.reset(typeID);
+        }
+    }
+
+    for (auto query : queriesByType[typeID]) {
+        query->invalidate();
+    }
+
+    if (changes[typeID]) {
+        changes[typeID]->removeAll(tick());
+    }
+}
+
+void ComponentManager::allComponentsCleared() {
+    if (entityManager) {
+        for (auto& signature : entityManager->signatures) {
+            signature.reset();
+        }
+    }
+
+    for (auto& query : queries) {
+        query.second->invalidate();
+    }
+
+    for (auto& typeChanges : changes) {
+        if (typeChanges) {
+            typeChanges->removeAll(tick());
+        }
+    }
+}
+
+void ComponentManager::entitiesDestroyed(const std::vector<EntityID>& sortedEntities) {
+    for (auto& query : queries) {
+        query.second->entitiesDestroyed(sortedEntities);
+    }
+
+    for (auto& typeChanges : changes) {
+        if (typeChanges) {
+            for (auto entityID : sortedEntities) {
+                typeChanges->remove(entityID, tick());
+            }
+        }
+    }
+}
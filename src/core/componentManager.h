@@ -1,10 +1,22 @@
 #pragma once
 #include <memory>
-#include <thread>
-#include <mutex>
+#include <algorithm>
 #include <unordered_map>
 #include <type_traits>
+#include <typeindex>
+#include <mutex>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <tuple>
 #include "componentContainer.h"
+#include "componentStorage.h"
+#include "view.h"
+#include "cachedQuery.h"
+#include "componentCursor.h"
+#include "componentChanges.h"
+#include "threadPool.h"
+#include "componentAccess.h"
 #include "entityID.h"
 #include "globalDefs.h"
 #include "componentContainerID.h"
@@ -19,6 +31,7 @@ template <class ComponentType>
 class ComponentHandle {
     static_assert(std::is_base_of<Component<ComponentType>, ComponentType>::value,
                   "ComponentHandle can only operate on Components");
+    static_assert(isAddressableComponent<ComponentType>, "ComponentHandle can't refer to component in SoAStorage!");
 
    public:
     ComponentHandle(ComponentManager& compManager, ComponentType* component)
@@ -42,6 +55,7 @@ class ComponentHandle {
 
 // Holds all components demanded in intersection() call by pointer and provides convenient access to them by reference,
 // for ex. intersectComps.get<PositionComponent>().x = 56 or bool collided = intComps.get<CollisionComp>.state;
+// Types are given like in intersection() call, so components of const-qualified types are accessed by get<const T>().
 // To get entity id which corresponds to all these components, call 'entity' method.
 template <typename... ComponentTypes>
 class IntersectionComponents {
@@ -57,15 +71,30 @@ class IntersectionComponents {
     std::tuple<ComponentTypes*...> components;
     EntityID entityID;
 
-    template <typename ComponentType>
+    template <size_t Index, typename ComponentType>
     void set(ComponentType& component) {
-        std::get<ComponentType*>(components) = &component;
+        std::get<Index>(components) = &component;
     }
 
     friend class ComponentManager;
 };
 
+// Type returned by getComponent of container of type T.
+template <class T>
+using ContainerPointer = decltype(std::declval<ContainerFor<T>&>().getComponent(EntityID()));
+
+// Type through which component of type T is accessed: T* for most components(so pointer to const for const-qualified
+// T), SoAReference<T> for ones in SoAStorage.
+template <class T>
+using ComponentPointer = std::conditional_t<std::is_pointer<ContainerPointer<T>>::value, T*, ContainerPointer<T>>;
+
 // Stores all components in the system. Provides facilities to add, delete, and get components by various methods.
+//
+// Methods which give access to components take their types as template arguments. Type can be const-qualified, for ex.
+// getComponent<const Position>(entity) or view<const Position, Velocity>(), to get read-only access to components of
+// this type, through pointers and references to const. In debug builds, access is validated against declarations of
+// Task currently updated on the calling thread(see ComponentAccess): types given without const are validated as
+// written, const-qualified ones as read, so Task which declares Reads<Position> has to use the latter.
 class ComponentManager {
    public:
     ComponentManager() {
@@ -73,24 +102,58 @@ class ComponentManager {
         for (const auto& container : singleComponentContainerArchetypes()) {
             containers.emplace_back(container->getNewClassInstance());
         }
+        queriesByType.resize(containers.size());
+
+        changes.resize(containers.size());
+        for (size_t typeID = 0; typeID < changeTrackingComponentTypes().size(); typeID++) {
+            if (changeTrackingComponentTypes()[typeID]) {
+                changes[typeID] = std::make_unique<ComponentChanges>();
+            }
+        }
     }
 
     // Returns ComponentHandle to the created component. If it failed to create new component, handle will point to
     //  nullptr. Arguments after entityID are forwarded to constructor of the created component.
+    // For components in SoAStorage, SoAReference is returned instead.
     template <class T, class... Args>
-    ComponentHandle<T> addComponent(EntityID entityID, Args&&... args) {
+    auto addComponent(EntityID entityID, Args&&... args) {
         if (!entityExists(entityID)) {
-            return ComponentHandle<T>(*this, nullptr);
+            return makeHandle<T>(ComponentPointer<T>(nullptr));
         }
 
-        auto componentPtr = getContainer<T>()->addComponent(entityID, std::forward<Args>(args)...);
-        return ComponentHandle<T>(*this, componentPtr);
+        auto component = getContainer<T>(true)->addComponent(entityID, std::forward<Args>(args)...);
+        if (component) {
+            componentChanged(entityID, ComponentContainerID::get<T>(), true);
+        }
+
+        return makeHandle<T>(component);
+    }
+
+    // Adds component of type T to every given entity, in single pass over the container. Each component is constructed
+    // from args. Null and non-existent entities are skipped, duplicates are ignored. Returns number of added or
+    // replaced components.
+    template <class T, class... Args>
+    size_t addComponents(std::vector<EntityID> entities, const Args&... args) {
+        std::sort(entities.begin(), entities.end());
+        entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+        entities.erase(std::remove_if(entities.begin(), entities.end(),
+                                      [this](EntityID entityID) { return entityID == 0 || !entityExists(entityID); }),
+                       entities.end());
+
+        getContainer<T>(true)->addComponents(entities, args...);
+        componentsChanged(entities, ComponentContainerID::get<T>(), true);
+        return entities.size();
     }
 
     // Deletes component owned by given entity. Returns true if it was deleted, false if it didn't exist.
     template <class T>
     bool deleteComponent(EntityID entityID) {
-        return getContainer<T>()->deleteComponent(entityID);
+        if (!getContainer<T>(true)->deleteComponent(entityID)) {
+            return false;
+        }
+
+        componentChanged(entityID, ComponentContainerID::get<T>(), false);
+        return true;
     }
 
     // Deletes all components
@@ -98,32 +161,113 @@ class ComponentManager {
         for (auto& container : containers) {
             container->clear();
         }
+        allComponentsCleared();
     }
 
     // Deletes all *T* components.
     template <class T>
     void clear() {
-        getContainer<T>()->clear();
+        getContainer<T>(true)->clear();
+        componentsCleared(ComponentContainerID::get<T>());
     }
 
     // returns pointer to component of type T, owned by entity specified by argument, or nullptr if it doesn't exists.
+    // For components in SoAStorage, SoAReference is returned instead. Pointer is to const if T is const-qualified.
     template <class T>
-    T* getComponent(EntityID entityID) {
+    ComponentPointer<T> getComponent(EntityID entityID) {
         return getContainer<T>()->getComponent(entityID);
     }
 
     // the same as getComponent, but returns ComponentHandle instead.
     template <class T>
-    ComponentHandle<T> getComponentHandle(EntityID entityID) {
-        return ComponentHandle<T>(*this, getComponent<T>(entityID));
+    auto getComponentHandle(EntityID entityID) {
+        return makeHandle<T>(getComponent<T>(entityID));
+    }
+
+    // the same as getComponent, but also marks component as changed(see markChanged).
+    template <class T>
+    ComponentPointer<T> modifyComponent(EntityID entityID) {
+        static_assert(!std::is_const<T>::value, "Modified component type can't be const-qualified!");
+        // access is validated as write by getComponent
+        auto component = getComponent<T>(entityID);
+        if (component) {
+            changesOf<T>().change(entityID, tick());
+        }
+
+        return component;
+    }
+
+    // stamps component of type T owned by given entity with current tick, so it's reported by changed<T>(). Adding
+    // or replacing component marks it automatically, but modification through pointers has to be reported this way.
+    // Can be called concurrently for different entities. Validated as write of T.
+    template <class T>
+    void markChanged(EntityID entityID) {
+        static_assert(!std::is_const<T>::value, "Modified component type can't be const-qualified!");
+        validateAccess<T>(true);
+        changesOf<T>().change(entityID, tick());
+    }
+
+    // returns entities whose components of type T were added after given tick, for ex. lastRunTick of a Task.
+    // Queries of changes are validated as reads of T.
+    template <class T>
+    std::vector<EntityID> added(uint64_t sinceTick) {
+        validateAccess<T>(false);
+        return changesOf<T>().addedSince(sinceTick);
+    }
+
+    // returns entities whose components of type T were added, replaced or marked as changed after given tick.
+    template <class T>
+    std::vector<EntityID> changed(uint64_t sinceTick) {
+        validateAccess<T>(false);
+        return changesOf<T>().changedSince(sinceTick);
     }
 
+    // returns entities whose components of type T were removed after given tick, including removal with entity.
+    template <class T>
+    std::vector<EntityID> removed(uint64_t sinceTick) {
+        validateAccess<T>(false);
+        return changesOf<T>().removedSince(sinceTick);
+    }
+
+    // current tick, which stamps changes of components. Ticks increase, so changes made after some tick have greater
+    // ones. Advanced by TaskScheduler before every update of a Task.
+    uint64_t tick() const { return currentTick.load(std::memory_order_relaxed); }
+
+    // advances tick, returns the new one.
+    uint64_t advanceTick() { return ++currentTick; }
+
+    // forgets removals stamped with given tick or earlier - they won't be reported by removed() anymore. Called by
+    // TaskScheduler with tick of the least recently run Task. Removals are kept until then, so if components are
+    // changed without TaskScheduler::update ever being called, it has to be called manually, with the oldest tick
+    // still passed to removed(), or removals accumulate.
+    void discardChangesUntil(uint64_t tick);
+
     // returns reference to container which contains all components of type T. This container should not be modified in
     // any way, as this may result in breaking system's assumptions about it's state. Elements in the container
-    // can be modified.
+    // can be modified, unless T is const-qualified - then reference to const container is returned. Its type depends
+    // on storage(see componentStorage.h): AlignedVector<T> for SortedStorage, SparseStorage and TagStorage, vector-like
+    // range of T& for PooledStorage and range of SoAReference<T> for SoAStorage. It used to be std::vector<T>&, so code
+    // which names that type has to use auto& instead.
     template <class T>
-    std::vector<T>& getAllComponents() {
-        return getContainer<T>()->getAllComponents();
+    auto& getAllComponents() {
+        auto& allComponents = getContainer<T>()->getAllComponents();
+        using AllComponents = std::remove_reference_t<decltype(allComponents)>;
+        return static_cast<std::conditional_t<std::is_const<T>::value, const AllComponents&, AllComponents&>>(
+            allComponents);
+    }
+
+    // moves components of type T owned by given entities to the beginning of getAllComponents<T>(), in given order, so
+    // they can be iterated alongside the entities, for ex. Hierarchy::entities, without looking them up. Entities must
+    // be unique, ones without component are skipped. Returns number of moved components. Available only for storages
+    // whose order is unspecified anyway(SparseStorage, TagStorage). Invalidates pointers to components of type T.
+    template <class T>
+    size_t orderBy(const std::vector<EntityID>& entities) {
+        auto moved = getContainer<T>(true)->orderBy(entities);
+        for (auto query : queriesByType[ComponentContainerID::get<T>()]) {
+            query->componentsMoved();
+        }
+
+        return moved;
     }
 
     // given list of types, gets all entities which have *at least* these types and returns vector of convenient
@@ -135,92 +279,332 @@ class ComponentManager {
     // Each element of vector have the same types(specified in intersection() call), which belong to the same entity.
     // components could be accessed like that:
     // comps.intersection<PositionComponent, MovementComponent>()[0].get<PositionComponent>().x = 5;
-    // Order of Entities in returned vector is undefined.
+    // Iteration is driven by the smallest of containers of given types, chosen at runtime, and entities are in the same
+    // order as in that container. Components of other types are found with ComponentCursors, so for containers sorted
+    // by entity id(SortedStorage) intersection is a merge-join, without full binary search per entity. If
+    // EntityManager is set, entities which lack any of the types are rejected by their signatures, before looking up
+    // their components.
+    // If ThreadPool is set(see setThreadPool), big containers are split into chunks processed in parallel. Each chunk
+    // gathers matching entities into its own buffer, and buffers are concatenated afterwards, so threads never contend.
     template <typename Head, typename... Tail>
     std::vector<IntersectionComponents<Head, Tail...>> intersection() {
-        auto& headComponents = getAllComponents<Head>();
+        static_assert(areAddressableComponents<Head, Tail...>(),
+                      "SoAStorage components have no references, use getComponent or getAllComponents!");
+        const size_t sizes[] = {getAllComponents<Head>().size(), getAllComponents<Tail>().size()...};
+        auto driver = (size_t)(std::min_element(std::begin(sizes), std::end(sizes)) - std::begin(sizes));
 
         std::vector<IntersectionComponents<Head, Tail...>> results;
-        results.reserve(headComponents.size());
-        std::mutex resultsMutex;
-
-        auto worker = [&](size_t startIndex, size_t endIndex) {
-            for (auto i = startIndex; i <= endIndex; i++) {
-                IntersectionComponents<Head, Tail...> currentEntityRequiredComponents;
-                if (fillWithRequiredComponents<IntersectionComponents<Head, Tail...>, Tail...>(
-                        headComponents[i].entityID, currentEntityRequiredComponents)) {
-                    currentEntityRequiredComponents.set(headComponents[i]);
-                    currentEntityRequiredComponents.entityID = headComponents[i].entityID;
-                    std::lock_guard<std::mutex> guard(resultsMutex);
-                    results.push_back(currentEntityRequiredComponents);
-                }
+        intersectionDrivenBy<Head, Tail...>(driver, results, std::index_sequence_for<Head, Tail...>{});
+        return results;
+    }
+
+    // calls function(T&) for every component of type T. If ThreadPool is set, components are processed in parallel,
+    // so function must be safe to call concurrently for different components.
+    template <class T, class Function>
+    void parallelForEach(Function&& function) {
+        auto& allComponents = getAllComponents<T>();
+        auto body = [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; i++) {
+                function(allComponents[i]);
             }
         };
 
-        size_t elemsPerThread = headComponents.size() / 8;
-
-        if (elemsPerThread < 3) {
-            worker(0, headComponents.size() - 1);
-            return results;
+        auto grain = parallelGrain(allComponents.size());
+        if (grain >= allComponents.size()) {
+            body(0, allComponents.size());
+        } else {
+            threadPool->parallelFor(0, allComponents.size(), grain, body);
         }
+    }
+
+    // calls function(chunk, count) for consecutive chunks of Width components of type T, with remaining components
+    // passed as last, shorter chunk(the scalar tail). For containers holding T by value chunk is T* to the first of
+    // count components; for SoAStorage it's SoAComponentContainer<T>::Components::Chunk, giving pointers to fields.
+    // Component arrays are aligned to componentAlignment bytes, so if Width * sizeof(field) is its multiple, every
+    // chunk starts aligned and full chunks can be processed with aligned vector loads. Not available for
+    // PooledStorage, as its components aren't contiguous.
+    // If ThreadPool is set, chunks are processed in parallel, like in parallelForEach.
+    // For ex.
+    // comps.forEachChunk<Velocity, 8>([](Velocity* velocities, size_t count) {
+    //     if (count == 8) { /* 8-wide kernel */ } else { /* scalar loop */ }
+    // });
+    template <class T, size_t Width = 16, class Function>
+    void forEachChunk(Function&& function) {
+        static_assert(Width > 0, "Chunk width must be positive!");
+        auto& allComponents = getAllComponents<T>();
+        auto body = [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; i += Width) {
+                function(chunkAt(allComponents, i), std::min(Width, end - i));
+            }
+        };
 
-        std::vector<std::thread> threads;
-        for (auto i = 0; i < 8; i++) {
-            threads.push_back(std::thread{worker, elemsPerThread * i, elemsPerThread * (i + 1) - 1});
+        // parallel chunks have to consist of whole Width-element chunks, so only the last one has a tail
+        auto grain = parallelGrain(allComponents.size());
+        if (grain >= allComponents.size()) {
+            body(0, allComponents.size());
+        } else {
+            grain = (grain + Width - 1) / Width * Width;
+            threadPool->parallelFor(0, allComponents.size(), grain, body);
         }
-        threads.push_back(
-            std::thread{worker, headComponents.size() - headComponents.size() % 8, headComponents.size() - 1});
+    }
 
-        for (auto& thread : threads) {
-            thread.join();
+    // given list of types, returns lazy range over all entities which have *at least* these types. Unlike
+    // intersection(), nothing is allocated - matching entities are found during iteration. See View for details.
+    // For ex.
+    // comps.view<PositionComponent, MovementComponent>().each([](EntityID entity, PositionComponent& position,
+    //                                                             MovementComponent& movement) { ... });
+    template <typename Head, typename... Tail>
+    View<Head, Tail...> view() {
+        static_assert(areAddressableComponents<Head, Tail...>(),
+                      "SoAStorage components have no references, use getComponent or getAllComponents!");
+        return View<Head, Tail...>(signatures, getContainer<Head>(), getContainer<Tail>()...);
+    }
+
+    // the same as view(), but skips entities which have any of Excluded types, and passes Optional types by pointer.
+    // Excluded types are only tested for presence, so they are validated as read, whether const-qualified or not.
+    // For ex.
+    // comps.view<Transform, Renderable>(exclude<Hidden>, optional<Velocity>).each(
+    //     [](EntityID entity, Transform& transform, Renderable& renderable, Velocity* velocity) { ... });
+    template <typename Head, typename... Tail, typename... Excluded, typename... Optionals>
+    BasicView<Exclude<Excluded...>, Optional<Optionals...>, Head, Tail...> view(Exclude<Excluded...>,
+                                                                                 Optional<Optionals...> = {}) {
+        static_assert(areAddressableComponents<Head, Tail..., Optionals...>(),
+                      "SoAStorage components have no references, use getComponent or getAllComponents!");
+        return BasicView<Exclude<Excluded...>, Optional<Optionals...>, Head, Tail...>(
+            signatures, getContainer<Head>(), getContainer<Tail>()..., getContainer<Excluded>(false)...,
+            getContainer<Optionals>()...);
+    }
+
+    template <typename Head, typename... Tail, typename... Optionals, typename... Excluded>
+    BasicView<Exclude<Excluded...>, Optional<Optionals...>, Head, Tail...> view(Optional<Optionals...>,
+                                                                                 Exclude<Excluded...> = {}) {
+        return view<Head, Tail...>(Exclude<Excluded...>{}, Optional<Optionals...>{});
+    }
+
+    // returns query over all entities which have *at least* given types, whose results are cached and updated
+    // incrementally on every structural change of these types. Query is registered on the first call - it shouldn't
+    // be concurrent with adding or deleting components, so it's best done outside of parallel execution(for ex. in
+    // constructor of a Task). See CachedQuery.
+    // For ex.
+    // comps.cachedQuery<Transform, AIState>().each([](EntityID entity, Transform& transform, AIState& state) { ... });
+    template <typename Head, typename... Tail>
+    CachedQuery<Head, Tail...>& cachedQuery() {
+        static_assert(areAddressableComponents<Head, Tail...>(),
+                      "SoAStorage components have no references, use getComponent or getAllComponents!");
+        auto headContainer = getContainer<Head>();
+        std::lock_guard<std::mutex> lock(queriesMutex);
+        auto& query = queries[std::type_index(typeid(CachedQuery<Head, Tail...>))];
+        if (!query) {
+            query = std::make_unique<CachedQuery<Head, Tail...>>(signatures, headContainer, getContainer<Tail>()...);
+            for (auto typeID : {ComponentContainerID::get<Head>(), ComponentContainerID::get<Tail>()...}) {
+                queriesByType[typeID].push_back(query.get());
+            }
         }
 
-        return results;
+        return *(CachedQuery<Head, Tail...>*)query.get();
     }
 
     // Checks if pointer to the component is still valid, in very fast way. Pointer to the component could turn invalid
-    // if there was any addiction/deletion of any component which is the same type.
+    // if there was any addiction/deletion of any component which is the same type, unless it uses PooledStorage - then
+    // only deletion of the component itself invalidates it.
     template <class T>
     bool validComponentPointer(T* componentPtr, EntityID entityID) {
-        auto& comps = getAllComponents<T>();
-        return &comps.front() <= componentPtr && componentPtr <= &comps.back() && componentPtr->entityID == entityID;
+        return getContainer<T>()->validPointer(componentPtr, entityID);
     }
 
-    void setEntityManager(const EntityManager& entityManager);
+    // links ComponentManager with EntityManager: components can be added only to existing entities, and signatures of
+    // entities(see EntityManager::signature) are kept up to date. Must be called before any component is added.
+    void setEntityManager(EntityManager& entityManager);
+
+    // sets pool used by parallel operations, like intersection(). Without it, they run on the calling thread.
+    void setThreadPool(ThreadPool& pool) { threadPool = &pool; }
 
    private:
     std::vector<std::unique_ptr<ComponentContainerBase>> containers;
-    const EntityManager* entityManager = nullptr;
+    EntityManager* entityManager = nullptr;
+    // signatures of entities, owned by entityManager. nullptr if it isn't set.
+    const std::vector<ComponentSignature>* signatures = nullptr;
+
+    ThreadPool* threadPool = nullptr;
+
+    std::mutex queriesMutex;
+    std::unordered_map<std::type_index, std::unique_ptr<CachedQueryBase>> queries;
+    // cached queries which have given component type, indexed by ComponentContainerID.
+    std::vector<std::vector<CachedQueryBase*>> queriesByType;
+
+    // changes of component types which track them, indexed by ComponentContainerID. nullptr for other types.
+    std::vector<std::unique_ptr<ComponentChanges>> changes;
+    std::atomic<uint64_t> currentTick{1};
+
+    template <class T>
+    ComponentChanges& changesOf() {
+        static_assert(T::trackChanges, "Component type doesn't track changes, declare trackChanges in it!");
+        return *changes[ComponentContainerID::get<T>()];
+    }
+
+    // validates access to components of type T against access declared by Task, in debug builds.
+    template <class T>
+    static void validateAccess(bool write) {
+#ifndef NDEBUG
+        ComponentAccess::validate(ComponentContainerID::get<T>(), write);
+#else
+        (void)write;
+#endif
+    }
+
+    // parallel operations won't create chunk of fewer elements than that.
+    static constexpr size_t minElementsPerChunk = 256;
+
+    // returns size of chunk which given number of elements should be split into, when processed in parallel.
+    // Returns at least elementCount if processing shouldn't be split at all.
+    size_t parallelGrain(size_t elementCount) const {
+        if (!threadPool || threadPool->size() == 1) {
+            return std::max<size_t>(elementCount, 1);
+        }
+
+        // few chunks per thread, so threads which finished early can steal remaining work
+        return std::max(minElementsPerChunk, elementCount / (threadPool->size() * 4) + 1);
+    }
     bool entityExists(EntityID entity);
 
+    // checks if entity has all component types from given signature, according to its signature. Always true if
+    // signatures aren't tracked.
+    bool hasSignature(EntityID entityID, const ComponentSignature& required) const {
+        auto index = entityIndex(entityID);
+        return !signatures || index >= signatures->size() || (*signatures)[index].containsAll(required);
+    }
+
+    // updates signatures, cached queries and changes after component of given type was added to(owned is true) or
+    // deleted from given entities. Entities passed to componentsChanged must be sorted and unique.
+    void componentChanged(EntityID entityID, size_t typeID, bool owned);
+    void componentsChanged(const std::vector<EntityID>& entities, size_t typeID, bool owned);
+
+    // updates signatures, cached queries and changes after all components of given type were deleted.
+    void componentsCleared(size_t typeID);
+    // updates signatures, cached queries and changes after all components were deleted.
+    void allComponentsCleared();
+
+    // updates cached queries and changes after given entities were deleted. Entities must be sorted and unique.
+    void entitiesDestroyed(const std::vector<EntityID>& sortedEntities);
+
+    // write should be true if caller is about to add, delete or modify components. It's used to validate access
+    // declared by Tasks in debug builds. By default, only const-qualified types are read.
     template <class T>
-    ComponentContainer<T>* getContainer() {
-        static_assert(std::is_base_of<Component<T>, T>::value, "T must be a component type!");
-        return (ComponentContainer<T>*)containers[ComponentContainerID::get<T>()].get();
+    ContainerFor<T>* getContainer(bool write = !std::is_const<T>::value) {
+        static_assert(std::is_base_of<Component<std::remove_const_t<T>>, std::remove_const_t<T>>::value,
+                      "T must be a component type!");
+        validateAccess<T>(write);
+        return (ContainerFor<T>*)containers[ComponentContainerID::get<T>()].get();
     }
 
-    // Fills second argument with required components. Returns true if all required components belonging to given entity
-    // were found
-    template <typename IntersectComponents, typename Head, typename... Tail>
-    bool fillWithRequiredComponents(EntityID entityID, IntersectComponents& components) {
-        static_assert(std::is_base_of<Component<Head>, Head>::value,
-                      "Interseciton template parameters must all be descended from Component!");
+    template <class T>
+    ComponentHandle<T> makeHandle(T* component) {
+        return ComponentHandle<T>(*this, component);
+    }
 
-        auto currentComponent = getComponent<Head>(entityID);
-        if (!currentComponent) {
-            return false;
+    // components in SoAStorage have no addresses to keep track of, so their references are returned as they are.
+    template <class T>
+    SoAReference<T> makeHandle(SoAReference<T> component) {
+        return component;
+    }
+
+    // returns chunk of components starting at given index, passed to function given to forEachChunk.
+    template <class T>
+    static T* chunkAt(AlignedVector<T>& components, size_t begin) {
+        return components.data() + begin;
+    }
+
+    template <class T>
+    static const T* chunkAt(const AlignedVector<T>& components, size_t begin) {
+        return components.data() + begin;
+    }
+
+    template <class Components>
+    static auto chunkAt(Components& components, size_t begin) -> decltype(components.chunk(begin)) {
+        return components.chunk(begin);
+    }
+
+    // fills results with intersection of Types, driven by container of type with given index.
+    template <typename... Types, size_t... Indices>
+    void intersectionDrivenBy(size_t driver, std::vector<IntersectionComponents<Types...>>& results,
+                              std::index_sequence<Indices...>) {
+        (void)driver;
+        (void)std::initializer_list<int>{
+            (driver == Indices ? (results = intersectionFrom<std::tuple_element_t<Indices, std::tuple<Types...>>,
+                                                             Types...>(),
+                                  0)
+                               : 0)...};
+    }
+
+    // returns intersection of Types, iterating over components of Driver type.
+    template <typename Driver, typename... Types>
+    std::vector<IntersectionComponents<Types...>> intersectionFrom() {
+        using Components = IntersectionComponents<Types...>;
+        auto& driverComponents = getAllComponents<Driver>();
+        auto containers = std::make_tuple(getContainer<Types>()...);
+        static const auto signature = ComponentContainerID::signature<Types...>();
+
+        auto worker = [&](size_t startIndex, size_t endIndex, std::vector<Components>& results) {
+            std::tuple<ComponentCursor<ContainerFor<Types>>...> cursors(std::get<ContainerFor<Types>*>(containers)...);
+            for (auto i = startIndex; i < endIndex; i++) {
+                auto entityID = driverComponents[i].entityID;
+                if (!hasSignature(entityID, signature)) {
+                    continue;
+                }
+
+                Components currentEntityRequiredComponents;
+                if (findComponents(entityID, cursors, currentEntityRequiredComponents,
+                                   std::index_sequence_for<Types...>{})) {
+                    currentEntityRequiredComponents.entityID = entityID;
+                    results.push_back(currentEntityRequiredComponents);
+                }
+            }
+        };
+
+        auto grain = parallelGrain(driverComponents.size());
+        if (grain >= driverComponents.size()) {
+            std::vector<Components> results;
+            worker(0, driverComponents.size(), results);
+            return results;
         }
 
-        if (fillWithRequiredComponents<IntersectComponents, Tail...>(entityID, components)) {
-            components.set(*currentComponent);
-            return true;
+        std::vector<std::vector<Components>> partialResults((driverComponents.size() + grain - 1) / grain);
+        threadPool->parallelFor(0, driverComponents.size(), grain, [&](size_t begin, size_t end) {
+            worker(begin, end, partialResults[begin / grain]);
+        });
+
+        size_t resultsCount = 0;
+        for (const auto& partial : partialResults) {
+            resultsCount += partial.size();
         }
 
-        return false;
+        std::vector<Components> results;
+        results.reserve(resultsCount);
+        for (const auto& partial : partialResults) {
+            results.insert(results.end(), partial.begin(), partial.end());
+        }
+
+        return results;
+    }
+
+    // Fills components with ones belonging to given entity, found by cursors. Returns true if all of them were found.
+    template <class Cursors, class Components, size_t... Indices>
+    static bool findComponents(EntityID entityID, Cursors& cursors, Components& components,
+                               std::index_sequence<Indices...>) {
+        bool found = true;
+        (void)std::initializer_list<int>{
+            (found = found && findComponent<Indices>(entityID, std::get<Indices>(cursors), components), 0)...};
+        return found;
     }
 
-    template <typename IntersectComponents>
-    bool fillWithRequiredComponents(EntityID, IntersectComponents) {
+    template <size_t Index, class Cursor, class Components>
+    static bool findComponent(EntityID entityID, Cursor& cursor, Components& components) {
+        auto component = cursor.find(entityID);
+        if (!component) {
+            return false;
+        }
+
+        components.template set<Index>(*component);
         return true;
     }
 
@@ -228,6 +612,7 @@ class ComponentManager {
     friend class ComponentRegistrator;
     friend class EntityManager;
     friend class Entity;
+    friend class CommandBuffer;
 };
 
 // implementation of method from ComponentHandle which depends on definition of ComponentManager.
@@ -0,0 +1,97 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+#include "componentContainer.h"
+#include "sparseComponentContainer.h"
+#include "pooledComponentContainer.h"
+#include "soaComponentContainer.h"
+
+namespace EECS {
+// Storage policies of components. Component type selects one by declaring Storage type alias, for example:
+//
+// struct Projectile : Component<Projectile> {
+//     using Storage = SparseStorage;
+// };
+//
+// Without such declaration, component uses DefaultStorage inherited from Component base.
+
+// Components kept in vector sorted by entity id: O(lg n) lookup, O(n) add/delete, iteration in entity order.
+struct SortedStorage {
+    template <class T>
+    using Container = ComponentContainer<T>;
+};
+
+// Components kept in sparse set: O(1) lookup, add and delete, iteration in unspecified order.
+struct SparseStorage {
+    template <class T>
+    using Container = SparseComponentContainer<T>;
+};
+
+// Components kept in pool of pages, never moved: O(1) lookup, add and delete, pointers stay valid until the component
+// is deleted, so ComponentHandle checks them in O(1). Iteration in unspecified order, through pointers.
+struct PooledStorage {
+    template <class T>
+    using Container = PooledComponentContainer<T>;
+};
+
+// Each field listed by component kept in separate array, sorted by entity id: O(lg n) lookup, O(n) add/delete.
+// Component has to list its fields in static fields() method, returning tuple of member pointers, for ex.
+//
+// struct Position : Component<Position> {
+//     using Storage = SoAStorage;
+//     static auto fields() { return std::make_tuple(&Position::x, &Position::y); }
+//
+//     float x = 0, y = 0;
+// };
+//
+// Components are accessed through SoAReference instead of pointers and references, so they can't be used in views,
+// intersections, cached queries, ComponentHandles or Entity::component - these fail to compile for them(see
+// isAddressableComponent). See SoAComponentContainer.
+struct SoAStorage {
+    template <class T>
+    using Container = SoAComponentContainer<T>;
+};
+
+// True for tag components, which have no data besides entityID inherited from Component base, for ex.
+// `struct Enemy : Component<Enemy> {};`. Any additional member makes component bigger, padding included.
+template <class T>
+constexpr bool isTagComponent = sizeof(T) == sizeof(EntityID);
+
+// Tags kept in sparse set, the same as SparseStorage. Tag is only its entity id, so tagged entity costs sizeof(EntityID)
+// in the dense vector, plus 4-byte slot in sparse array, whose pages cover 4096 entity indices each. In exchange,
+// lookup, add and delete are O(1) and never shift other tags, unlike in SortedStorage, and iteration order is
+// unspecified. Checking whether entity has a tag is single bit test if signatures of entities are tracked(see
+// EntityManager::hasAll), and views test excluded tags this way.
+struct TagStorage {
+    template <class T>
+    using Container = SparseComponentContainer<T>;
+};
+
+// Storage inherited from Component base: TagStorage for tag components, detected at compile time, SortedStorage for
+// other ones. Tag which declares Storage explicitly uses it instead.
+struct DefaultStorage {
+    template <class T>
+    using Container = typename std::conditional_t<isTagComponent<T>, TagStorage, SortedStorage>::template Container<T>;
+};
+
+// Container type used for storing components of type T. Const-qualified type uses the same container as T itself.
+template <class T>
+using ContainerFor = typename std::remove_const_t<T>::Storage::template Container<std::remove_const_t<T>>;
+
+// True if components of type T are accessed through pointers and references, which is the case for every storage
+// except SoAStorage. Facilities which hand out T* or T& check it with static_assert.
+template <class T>
+constexpr bool isAddressableComponent =
+    std::is_pointer<decltype(std::declval<ContainerFor<T>&>().getComponent(EntityID()))>::value;
+
+template <class... Types>
+constexpr bool areAddressableComponents() {
+    const bool addressable[] = {true, isAddressableComponent<Types>...};
+    for (auto value : addressable) {
+        if (!value) {
+            return false;
+        }
+    }
+    return true;
+}
+}
@@ -4,23 +4,31 @@
 
 using namespace EECS;
 
-EECS::ECS::ECS(const std::string& configFilename) : entities(components), tasks(*this) {
+EECS::ECS::ECS(const std::string& configFilename) : entities(components), tasks(*this), threads(1) {
     components.setEntityManager(entities);
 
     if (!configFilename.empty()) {
         config.load(configFilename);
     }
+
+    threads.setThreadCount(config.get("threadPool.threadCount", (size_t)std::thread::hardware_concurrency()));
+    components.setThreadPool(threads);
+    events.setThreadPool(threads);
 }
 
 void EECS::ECS::run() {
     Timer timer;
     std::chrono::milliseconds elapsedTime{0};
 
+    // events pushed by receivers are delivered in the same iteration, up to this many rounds of emission. One round
+    // would leave events pushed for types emitted earlier in the round to the next iteration.
+    auto emitRounds = config.get("events.maxEmitRounds", (size_t)8);
+
     while (!quit) {
         auto durationUntilNextUpdateNecessary = tasks.update(elapsedTime);
         auto timeSpentSinceLastUpdate = Timer{};
 
-        events.emit();
+        events.emitUntilQuiescent(emitRounds);
 
         std::this_thread::sleep_for(durationUntilNextUpdateNecessary - timeSpentSinceLastUpdate.elapsed());
         elapsedTime = std::max(std::chrono::milliseconds(0), timer.reset());
@@ -4,12 +4,15 @@
 #include "entityManager.h"
 #include "taskScheduler.h"
 #include "eventQueue.h"
+#include "threadPool.h"
+#include "resources.h"
 
 namespace EECS {
 /** class that encapsulates whole ECS
 *
 * It ties all components together and manages it's configuration.
 * It measures delta time for TaskScheduler.
+* It owns ThreadPool used by parallel operations of its components.
 */
 class ECS {
    public:
@@ -24,10 +27,19 @@ class ECS {
     ComponentManager components;
     EntityManager entities;
     TaskScheduler tasks;
+    // emitted after Tasks in every iteration of run(). Events pushed by receivers are delivered in the same iteration,
+    // up to events.maxEmitRounds(8 by default) rounds of emission.
     EventQueue events;
 
+    // global state, like camera, time or input, which doesn't belong to any entity.
+    Resources resources;
+
     Configuration config;
 
+    // shared by all parallel operations of the engine. Size is read from threadPool.threadCount setting, by default
+    // it's number of hardware threads.
+    ThreadPool threads;
+
    private:
     bool quit = false;
 };
@@ -37,9 +37,11 @@ class Entity {
 
     template <class T>
     T* component() {
+        static_assert(isAddressableComponent<T>,
+                      "SoAStorage components have no references, use ComponentManager::getComponent!");
         if (cachedComponent.first != ComponentContainerID::get<T>() ||
             !components.validComponentPointer((T*)cachedComponent.second, id)) {
-            cachedComponent = {ComponentContainerID::get<T>(), components.getComponent<T>(id)};
+            cachedComponent = {ComponentContainerID::get<T>(), findComponent<T>()};
         }
 
         return (T*)cachedComponent.second;
@@ -47,16 +49,32 @@ class Entity {
 
     template <class T>
     ComponentHandle<T> componentHandle() {
+        static_assert(isAddressableComponent<T>,
+                      "SoAStorage components have no references, use ComponentManager::getComponent!");
         if (cachedComponent.first != ComponentContainerID::get<T>() ||
             !components.validComponentPointer((T*)cachedComponent.second, id)) {
-            cachedComponent = {ComponentContainerID::get<T>(), components.getComponent<T>(id)};
+            cachedComponent = {ComponentContainerID::get<T>(), findComponent<T>()};
         }
 
         return ComponentHandle<T>{components, (T*)cachedComponent.second};
     }
 
+    // checks if entity has all of given component types, see EntityManager::hasAll.
+    template <class... Types>
+    bool hasAll() {
+        return entities.hasAll<Types...>(id);
+    }
+
+    // checks if entity has at least one of given component types, see EntityManager::hasAny.
+    template <class... Types>
+    bool hasAny() {
+        return entities.hasAny<Types...>(id);
+    }
+
     template <class T, class... Args>
     T* addComponent(Args&&... args) {
+        static_assert(isAddressableComponent<T>,
+                      "SoAStorage components have no references, use ComponentManager::addComponent!");
         return components.addComponent<T>(id, std::forward<Args>(args)...);
     }
 
@@ -70,5 +88,15 @@ class Entity {
     EntityManager& entities;
     ComponentManager& components;
     std::pair<size_t, void*> cachedComponent;
+
+    // looks up component, unless signature of the entity shows it doesn't exist.
+    template <class T>
+    T* findComponent() {
+        if (entities.tracksSignatures() && !entities.hasAll<T>(id)) {
+            return nullptr;
+        }
+
+        return components.getComponent<T>(id);
+    }
 };
 }
@@ -2,5 +2,20 @@
 #include <cstdint>
 
 namespace EECS {
+// Identifies an entity. Lower 32 bits are index of the entity's slot in EntityManager, upper 32 bits are generation
+// of that slot - it's incremented whenever slot is reused, so ids of deleted entities never become valid again.
+// 0 is null entity.
 using EntityID = uint64_t;
+
+inline uint32_t entityIndex(EntityID entityID) { return (uint32_t)entityID; }
+
+inline uint32_t entityGeneration(EntityID entityID) { return (uint32_t)(entityID >> 32); }
+
+inline EntityID makeEntityID(uint32_t index, uint32_t generation) { return (EntityID)generation << 32 | index; }
+
+// generation reserved for ids of entities which will be created later, by CommandBuffer. Existing entities never
+// have it.
+constexpr uint32_t deferredEntityGeneration = UINT32_MAX;
+
+inline bool isDeferredEntity(EntityID entityID) { return entityGeneration(entityID) == deferredEntityGeneration; }
 }
@@ -1,12 +1,26 @@
 #include "entity.h"
+#include <algorithm>
 
 namespace EECS {
 
+constexpr size_t Hierarchy::noParent;
+
 Entity EntityManager::getEntity(EntityID entityID) { return {entityID, *this, componentManager}; }
 
 Entity EntityManager::addEntity() {
-    entityExistence[++lastEntity] = true;
-    return {lastEntity, *this, componentManager};
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.emplace_back();
+        signatures.emplace_back();
+        relations.emplace_back();
+    }
+
+    slots[index].alive = true;
+    return {makeEntityID(index, slots[index].generation), *this, componentManager};
 }
 
 Entity EntityManager::cloneEntity(EntityID source) {
@@ -16,9 +30,10 @@ Entity EntityManager::cloneEntity(EntityID source) {
 
     Entity target = addEntity();
 
-    for (auto& container : componentManager.containers) {
-        if (container) {
-            container->cloneComponent(source, target);
+    for (size_t typeID = 0; typeID < componentManager.containers.size(); typeID++) {
+        auto& container = componentManager.containers[typeID];
+        if (container && container->cloneComponent(source, target)) {
+            componentManager.componentChanged(target, typeID, true);
         }
     }
 
@@ -26,24 +41,249 @@ Entity EntityManager::cloneEntity(EntityID source) {
 }
 
 bool EntityManager::deleteEntity(EntityID entityID) {
-    auto it = entityExistence.find(entityID);
-    if (it == entityExistence.end()) {
+    if (!entityExists(entityID)) {
         return false;
     }
 
+    // descendants are deleted too, in one batch
+    if (relations[entityIndex(entityID)].firstChild != 0) {
+        return destroyEntities({entityID}) > 0;
+    }
+
     for (auto& container : componentManager.containers) {
         container->genericDeleteComponent(entityID);
     }
+    componentManager.entitiesDestroyed({entityID});
 
-    entityExistence.erase(it);
+    detach(entityIndex(entityID));
+    releaseSlot(entityIndex(entityID));
     return true;
 }
 
+std::vector<EntityID> EntityManager::createEntities(size_t count) {
+    std::vector<EntityID> created;
+    created.reserve(count);
+
+    while (created.size() < count && !freeIndices.empty()) {
+        auto index = freeIndices.back();
+        freeIndices.pop_back();
+        slots[index].alive = true;
+        created.push_back(makeEntityID(index, slots[index].generation));
+    }
+
+    auto firstNewIndex = slots.size();
+    slots.resize(slots.size() + count - created.size());
+    signatures.resize(slots.size());
+    relations.resize(slots.size());
+    for (auto index = firstNewIndex; index < slots.size(); index++) {
+        slots[index].alive = true;
+        created.push_back(makeEntityID((uint32_t)index, slots[index].generation));
+    }
+
+    return created;
+}
+
+size_t EntityManager::destroyEntities(std::vector<EntityID> entities) {
+    std::sort(entities.begin(), entities.end());
+    entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+    entities.erase(std::remove_if(entities.begin(), entities.end(),
+                                  [this](EntityID entityID) { return !entityExists(entityID); }),
+                   entities.end());
+
+    // descendants of deleted entities which aren't deleted themselves
+    std::vector<uint32_t> descendants;
+    for (auto entityID : entities) {
+        for (auto child = relations[entityIndex(entityID)].firstChild; child != 0;
+             child = relations[child].nextSibling) {
+            if (!std::binary_search(entities.begin(), entities.end(), idOf(child))) {
+                descendants.push_back(child);
+            }
+        }
+    }
+    if (!descendants.empty()) {
+        appendDescendants(descendants, 0);
+        for (auto index : descendants) {
+            entities.push_back(idOf(index));
+        }
+        std::sort(entities.begin(), entities.end());
+        entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+    }
+
+    for (auto& container : componentManager.containers) {
+        container->genericDeleteComponents(entities);
+    }
+    componentManager.entitiesDestroyed(entities);
+
+    // all descendants are deleted too, so only links to parents which stay have to be removed
+    for (auto entityID : entities) {
+        detach(entityIndex(entityID));
+    }
+    for (auto entityID : entities) {
+        releaseSlot(entityIndex(entityID));
+    }
+
+    return entities.size();
+}
+
+bool EntityManager::setParent(EntityID child, EntityID parent) {
+    if (!entityExists(child) || (parent != 0 && !entityExists(parent))) {
+        return false;
+    }
+
+    auto childIndex = entityIndex(child);
+    auto parentIndex = entityIndex(parent);
+    for (auto ancestor = parentIndex; ancestor != 0; ancestor = relations[ancestor].parent) {
+        if (ancestor == childIndex) {
+            return false;
+        }
+    }
+
+    detach(childIndex);
+    if (parentIndex != 0) {
+        auto& relation = relations[childIndex];
+        auto& parentRelation = relations[parentIndex];
+        relation.parent = parentIndex;
+        relation.nextSibling = parentRelation.firstChild;
+        if (parentRelation.firstChild != 0) {
+            relations[parentRelation.firstChild].previousSibling = childIndex;
+        }
+        parentRelation.firstChild = childIndex;
+    }
+
+    hierarchyChanged = true;
+    return true;
+}
+
+EntityID EntityManager::getParent(EntityID entityID) const {
+    if (!entityExists(entityID) || relations[entityIndex(entityID)].parent == 0) {
+        return 0;
+    }
+
+    return idOf(relations[entityIndex(entityID)].parent);
+}
+
+std::vector<EntityID> EntityManager::getChildren(EntityID entityID) const {
+    std::vector<EntityID> children;
+    if (entityExists(entityID)) {
+        for (auto child = relations[entityIndex(entityID)].firstChild; child != 0;
+             child = relations[child].nextSibling) {
+            children.push_back(idOf(child));
+        }
+    }
+
+    return children;
+}
+
+std::vector<EntityID> EntityManager::getDescendants(EntityID entityID) const {
+    std::vector<uint32_t> indices;
+    if (entityExists(entityID)) {
+        indices.push_back(entityIndex(entityID));
+        appendDescendants(indices, 0);
+    }
+
+    std::vector<EntityID> descendants;
+    for (size_t i = 1; i < indices.size(); i++) {
+        descendants.push_back(idOf(indices[i]));
+    }
+
+    return descendants;
+}
+
+const Hierarchy& EntityManager::getHierarchy() {
+    if (!hierarchyChanged) {
+        return hierarchy;
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t index = 1; index < relations.size(); index++) {
+        if (relations[index].parent == 0 && relations[index].firstChild != 0) {
+            indices.push_back(index);
+        }
+    }
+
+    // position of every entity in the order, indexed by slot, so parents can be found by index
+    std::vector<size_t> positions(relations.size());
+    hierarchy.entities.clear();
+    hierarchy.parents.clear();
+    hierarchy.levels.clear();
+
+    size_t levelEnd = indices.size();
+    hierarchy.levels.push_back(0);
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (i == levelEnd) {
+            hierarchy.levels.push_back(i);
+            levelEnd = indices.size();
+        }
+
+        auto index = indices[i];
+        auto parent = relations[index].parent;
+        positions[index] = i;
+        hierarchy.entities.push_back(idOf(index));
+        hierarchy.parents.push_back(parent == 0 ? Hierarchy::noParent : positions[parent]);
+
+        for (auto child = relations[index].firstChild; child != 0; child = relations[child].nextSibling) {
+            indices.push_back(child);
+        }
+    }
+    hierarchy.levels.push_back(indices.size());
+
+    hierarchyChanged = false;
+    return hierarchy;
+}
+
+void EntityManager::detach(uint32_t index) {
+    auto& relation = relations[index];
+    if (relation.parent == 0) {
+        return;
+    }
+
+    if (relation.previousSibling != 0) {
+        relations[relation.previousSibling].nextSibling = relation.nextSibling;
+    } else {
+        relations[relation.parent].firstChild = relation.nextSibling;
+    }
+    if (relation.nextSibling != 0) {
+        relations[relation.nextSibling].previousSibling = relation.previousSibling;
+    }
+
+    relation.parent = relation.nextSibling = relation.previousSibling = 0;
+    hierarchyChanged = true;
+}
+
+void EntityManager::appendDescendants(std::vector<uint32_t>& indices, size_t first) const {
+    for (auto i = first; i < indices.size(); i++) {
+        for (auto child = relations[indices[i]].firstChild; child != 0; child = relations[child].nextSibling) {
+            indices.push_back(child);
+        }
+    }
+}
+
+void EntityManager::releaseSlot(uint32_t index) {
+    auto& slot = slots[index];
+    slot.alive = false;
+    signatures[index].reset();
+    if (relations[index].firstChild != 0) {
+        hierarchyChanged = true;
+    }
+    relations[index] = Relation();
+
+    // slot which exhausted its generations is never reused, otherwise stale ids would become valid again
+    if (slot.generation + 1 == deferredEntityGeneration) {
+        retiredSlots++;
+    } else {
+        slot.generation++;
+        freeIndices.push_back(index);
+    }
+}
+
 void EntityManager::clear() {
-    for (auto entityEntry : entityExistence) {
-        deleteEntity(entityEntry.first);
+    std::vector<EntityID> existing;
+    for (size_t index = 1; index < slots.size(); index++) {
+        if (slots[index].alive) {
+            existing.push_back(makeEntityID((uint32_t)index, slots[index].generation));
+        }
     }
 
-    entityExistence.clear();
+    destroyEntities(std::move(existing));
 }
 }
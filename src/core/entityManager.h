@@ -1,15 +1,58 @@
 #pragma once
-#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
 #include "componentManager.h"
+#include "componentContainerID.h"
 
 namespace EECS {
 class Entity;
 
+// entities which have parent or children, in breadth-first order - sorted by depth, so every entity comes after its
+// parent. Parents are given as indices into the same arrays, so for ex. transforms can be propagated in single linear
+// pass, without looking up parents:
+//
+// for (size_t i = 0; i < hierarchy.entities.size(); i++) {
+//     world[i] = hierarchy.parents[i] == Hierarchy::noParent ? local[i] : world[hierarchy.parents[i]] * local[i];
+// }
+//
+// Entities of depth d occupy range [levels[d], levels[d + 1]), so every level can be processed in parallel. Components
+// in SparseStorage can be arranged in the same order with ComponentManager::orderBy, so they are read in the same pass
+// by index, without lookups.
+struct Hierarchy {
+    static constexpr size_t noParent = SIZE_MAX;
+
+    std::vector<EntityID> entities;
+    std::vector<size_t> parents;
+    std::vector<size_t> levels;
+};
+
+/** \brief creates, deletes and keeps track of existing entities
+*
+* Entities are stored in dense array of slots, indexed by entityIndex(EntityID). Slots of deleted entities are kept
+* on a free list and reused by newly created entities, with incremented generation, so memory doesn't grow under
+* churn and ids of deleted entities are recognized as stale.
+*
+* For every entity, set of its component types(signature) is kept, so checking whether entity has some components
+* doesn't require looking them up in containers. Signatures are maintained by ComponentManager linked with this
+* EntityManager(see ComponentManager::setEntityManager), as it's done in ECS.
+*
+* Entities can be arranged in hierarchy, with setParent. Deleting an entity deletes all its descendants too, in one
+* batch(see destroyEntities). Traversal order of the whole hierarchy is kept contiguous, in getHierarchy.
+*
+* EntityManager isn't thread-safe. Tasks updated concurrently record creating and deleting entities and setting
+* parents in their CommandBuffers. getHierarchy rebuilds the order lazily, so TaskScheduler calls it before updating
+* Tasks, which then only read the order built already.
+*/
 class EntityManager {
    public:
     explicit EntityManager(ComponentManager& componentManager) : componentManager(componentManager) {}
 
-    bool entityExists(EntityID entityID) const { return entityExistence.find(entityID) != entityExistence.end(); }
+    // checks if entity exists, in O(1). Returns false for ids of deleted entities, even if their slot was reused.
+    bool entityExists(EntityID entityID) const {
+        auto index = entityIndex(entityID);
+        return index < slots.size() && slots[index].alive && slots[index].generation == entityGeneration(entityID);
+    }
 
     Entity getEntity(EntityID entityID);
 
@@ -19,9 +62,121 @@ class EntityManager {
     bool deleteEntity(EntityID entityID);
     void clear();
 
+    // creates given number of entities at once, returns their ids.
+    std::vector<EntityID> createEntities(size_t count);
+
+    // deletes all given entities and their descendants with their components, in one pass over every component
+    // container. Ids of non-existent entities are ignored. Returns number of deleted entities.
+    size_t destroyEntities(std::vector<EntityID> entities);
+
+    // makes parent the parent of child, detaching it from previous one. Parent 0 only detaches child. Returns false if
+    // any of entities doesn't exist, or if parent is child itself or its descendant.
+    bool setParent(EntityID child, EntityID parent);
+
+    // returns parent of given entity, 0 if it doesn't have one.
+    EntityID getParent(EntityID entityID) const;
+
+    // returns children of given entity, in unspecified order.
+    std::vector<EntityID> getChildren(EntityID entityID) const;
+
+    // returns all descendants of given entity, in breadth-first order.
+    std::vector<EntityID> getDescendants(EntityID entityID) const;
+
+    // returns traversal order of all entities which have parent or children. It's rebuilt on first call after
+    // hierarchy is changed, so it's invalidated by setParent and deleting related entities. Rebuilding isn't
+    // synchronized, see class description.
+    const Hierarchy& getHierarchy();
+
+    // returns set of component types owned by given entity. Empty if entity doesn't exist.
+    const ComponentSignature& signature(EntityID entityID) const {
+        static const ComponentSignature empty;
+        return entityExists(entityID) ? signatures[entityIndex(entityID)] : empty;
+    }
+
+    // checks if entity has all of given component types. In O(1), unless ComponentManager isn't linked - then
+    // components are looked up.
+    template <class... Types>
+    bool hasAll(EntityID entityID) const {
+        if (!tracksSignatures()) {
+            return entityExists(entityID) && countComponents<Types...>(entityID) == sizeof...(Types);
+        }
+
+        static const auto required = ComponentContainerID::signature<Types...>();
+        return signature(entityID).containsAll(required);
+    }
+
+    // checks if entity has at least one of given component types. In O(1), unless ComponentManager isn't linked.
+    template <class... Types>
+    bool hasAny(EntityID entityID) const {
+        if (!tracksSignatures()) {
+            return entityExists(entityID) && countComponents<Types...>(entityID) > 0;
+        }
+
+        static const auto required = ComponentContainerID::signature<Types...>();
+        return signature(entityID).containsAny(required);
+    }
+
+    // number of existing entities.
+    size_t size() const { return slots.size() - 1 - freeIndices.size() - retiredSlots; }
+
    private:
-    std::unordered_map<EntityID, bool> entityExistence;
-    EntityID lastEntity = 0;
+    struct Slot {
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    // links of entity in hierarchy, as slot indices. 0 means no such entity, as slot 0 is never used.
+    struct Relation {
+        uint32_t parent = 0;
+        uint32_t firstChild = 0;
+        uint32_t nextSibling = 0;
+        uint32_t previousSibling = 0;
+    };
+
+    // slot 0 is reserved, so null entity never exists.
+    std::vector<Slot> slots{1};
+    // signatures of entities, indexed like slots. Kept apart from them, so they can be scanned densely.
+    std::vector<ComponentSignature> signatures{1};
+    // relations of entities, indexed like slots. Related entities always exist, as relations are removed with them.
+    std::vector<Relation> relations{1};
+    std::vector<uint32_t> freeIndices;
+    size_t retiredSlots = 0;
     ComponentManager& componentManager;
+
+    Hierarchy hierarchy;
+    bool hierarchyChanged = false;
+
+    // marks slot of deleted entity as free. Components must be already deleted.
+    void releaseSlot(uint32_t index);
+
+    EntityID idOf(uint32_t index) const { return makeEntityID(index, slots[index].generation); }
+
+    // removes entity with given index from children of its parent.
+    void detach(uint32_t index);
+
+    // appends indices of descendants of given entities to them, in breadth-first order.
+    void appendDescendants(std::vector<uint32_t>& indices, size_t first) const;
+
+    bool tracksSignatures() const { return componentManager.entityManager == this; }
+
+    // marks component type as owned or not owned by given entity. Ignored if entity doesn't exist. Can be called
+    // concurrently for different types, see ComponentSignature.
+    void setComponentBit(EntityID entityID, size_t typeID, bool owned) {
+        if (entityExists(entityID)) {
+            signatures[entityIndex(entityID)].set(typeID, owned);
+        }
+    }
+
+    // returns how many of given component types entity has, by looking them up.
+    template <class... Types>
+    size_t countComponents(EntityID entityID) const {
+        size_t count = 0;
+        (void)std::initializer_list<int>{
+            (count += (bool)componentManager.getComponent<const Types>(entityID), 0)...};
+        return count;
+    }
+
+    friend class ComponentManager;
+    friend class Entity;
 };
 }
@@ -0,0 +1,119 @@
+#include "eventQueue.h"
+#include <cstdint>
+#include <functional>
+
+using namespace EECS;
+
+void EventQueue::emit() {
+    if (waves.empty()) {
+        computeWaves();
+    }
+
+    // nothing can be pushed while events are collected, so all types are collected before any is dispatched. Events
+    // pushed by receivers are left for the next emit(), whether types are dispatched serially or concurrently.
+    for (const auto& wave : waves) {
+        for (auto eventID : wave) {
+            eventQueues[eventID]->collect();
+        }
+    }
+
+    auto concurrent = parallelEmit && threadPool && threadPool->size() > 1;
+    for (const auto& wave : waves) {
+        if (concurrent) {
+            dispatchConcurrently(wave);
+        } else {
+            for (auto eventID : wave) {
+                eventQueues[eventID]->dispatch();
+            }
+        }
+    }
+}
+
+bool EventQueue::emitUntilQuiescent(size_t maxRounds) {
+    for (size_t round = 0; round < maxRounds; round++) {
+        emit();
+        if (!hasPendingEvents()) {
+            return true;
+        }
+    }
+
+    return !hasPendingEvents();
+}
+
+bool EventQueue::hasPendingEvents() {
+    return std::any_of(eventQueues.begin(), eventQueues.end(), [](const std::unique_ptr<SingleEventQueueBase>& queue) {
+        return queue && queue->hasPendingEvents();
+    });
+}
+
+bool EventQueue::addPredecessor(size_t later, size_t earlier) {
+    if (later == earlier || waitsFor(earlier, later)) {
+        return false;
+    }
+
+    if (predecessors.size() <= later) {
+        predecessors.resize(later + 1);
+    }
+    predecessors[later].push_back(earlier);
+    waves.clear();
+    return true;
+}
+
+bool EventQueue::waitsFor(size_t first, size_t second) const {
+    if (first >= predecessors.size()) {
+        return false;
+    }
+
+    for (auto predecessor : predecessors[first]) {
+        if (predecessor == second || waitsFor(predecessor, second)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void EventQueue::computeWaves() {
+    // wave of type is one more than the latest wave of its predecessors. Predecessors never form cycles.
+    std::vector<size_t> waveOf(eventQueues.size(), SIZE_MAX);
+    std::function<size_t(size_t)> computeWave = [&](size_t eventID) {
+        if (waveOf[eventID] == SIZE_MAX) {
+            size_t wave = 0;
+            if (eventID < predecessors.size()) {
+                for (auto predecessor : predecessors[eventID]) {
+                    wave = std::max(wave, computeWave(predecessor) + 1);
+                }
+            }
+            waveOf[eventID] = wave;
+        }
+        return waveOf[eventID];
+    };
+
+    for (size_t eventID = 0; eventID < eventQueues.size(); eventID++) {
+        if (eventQueues[eventID]) {
+            auto wave = computeWave(eventID);
+            if (waves.size() <= wave) {
+                waves.resize(wave + 1);
+            }
+            waves[wave].push_back(eventID);
+        }
+    }
+}
+
+void EventQueue::dispatchConcurrently(const std::vector<size_t>& wave) {
+    TaskGroup group(*threadPool);
+    for (auto eventID : wave) {
+        auto queue = eventQueues[eventID].get();
+        if (queue->threadSafe()) {
+            group.run([queue] { queue->dispatch(); });
+        }
+    }
+
+    for (auto eventID : wave) {
+        if (!eventQueues[eventID]->threadSafe()) {
+            eventQueues[eventID]->dispatch();
+        }
+    }
+
+    group.wait();
+}
@@ -1,10 +1,12 @@
 #pragma once
 #include <memory>
 #include <algorithm>
+#include <functional>
 #include <type_traits>
 #include "singleEventQueue.h"
 #include "globalDefs.h"
 #include "event.h"
+#include "threadPool.h"
 
 namespace EECS {
 /** \brief stores pending messages of arbitrary amount of numbers
@@ -14,6 +16,12 @@ namespace EECS {
 *
 * receiver method returns true if event is to spread further into
 * lower-priority receivers, or false if it should vanish.
+*
+* Events can be pushed from many threads at once, for ex. from Tasks updated concurrently, without blocking - see
+* SingleEventQueue. Connecting, disconnecting and emitting must be done from single thread, while nothing is pushed.
+*
+* Event types can be emitted concurrently on ThreadPool, see setParallelEmit. Types are emitted in order of their ids,
+* except that type declared to be emitted after other types(see emitAfter) waits for them.
 */
 class EventQueue {
    public:
@@ -24,13 +32,70 @@ class EventQueue {
         }
     }
 
-    /** \brief emits all events in system at once, type by type. */
-    void emit() {
-        for (auto& eventType : eventQueues) {
-            if (eventType) {
-                eventType->emit();
-            }
-        }
+    /** \brief emits all events in system at once, type by type.
+    *
+    * Events of all types are collected before any type is dispatched, so events pushed by receivers, even of types
+    * emitted later, are emitted by the next emit() call(see emitUntilQuiescent).
+    */
+    void emit();
+
+    /** \brief emits events repeatedly, until receivers stop pushing new ones
+    *
+    * \param maxRounds upper limit of emit() calls, so receivers which keep pushing events can't stall the caller
+    *
+    * Events pushed by receivers during emission are delivered in the same call, instead of the next emit(). Returns
+    * true if there are no pending events left.
+    */
+    bool emitUntilQuiescent(size_t maxRounds);
+
+    /** \brief creates event and passes it to receivers right away
+    *
+    * \param args arguments to be passed to event's constructor
+    *
+    * Event isn't queued, so it's received without waiting for emit(). Receivers are called on the calling thread,
+    * so if it's done from concurrently updated Tasks, receivers have to be thread-safe.
+    */
+    template <typename EventType, typename... Args>
+    void dispatchNow(Args&&... args) {
+        EventType event(std::forward<Args>(args)...);
+        getQueue<EventType>()->dispatchNow(event);
+    }
+
+    /** \brief makes all events of particular type dispatched right away, as with dispatchNow
+    *
+    * \param immediate whether push and emplace of EventType should dispatch instead of queueing
+    */
+    template <typename EventType>
+    void setImmediate(bool immediate) {
+        getQueue<EventType>()->setImmediate(immediate);
+    }
+
+    /** \brief makes emit() dispatch different event types concurrently
+    *
+    * \param parallel whether event types should be dispatched concurrently
+    *
+    * Events of all types are collected first, then types are dispatched in waves - every wave consists of types
+    * whose predecessors(see emitAfter) were dispatched in previous waves. In every wave, types whose all receivers are
+    * thread-safe(see IsThreadSafeReceiver) are dispatched on ThreadPool, one job per type, while remaining types are
+    * dispatched one by one on the calling thread. Events pushed by receivers are emitted by the next emit() call.
+    * Requires ThreadPool to be set.
+    */
+    void setParallelEmit(bool parallel) { parallelEmit = parallel; }
+
+    // sets ThreadPool used for parallel emission.
+    void setThreadPool(ThreadPool& threadPool) { this->threadPool = &threadPool; }
+
+    /** \brief declares that events of type Later must be emitted after all events of type Earlier
+    *
+    * For ex. emitAfter<DamageEvent, CollisionEvent>() ensures that receivers of collisions are done before damage
+    * is dispatched, also when emitting concurrently. Returns false if Earlier is already emitted after Later, as
+    * such constraint can't be satisfied.
+    */
+    template <typename Later, typename Earlier>
+    bool emitAfter() {
+        getQueue<Later>();
+        getQueue<Earlier>();
+        return addPredecessor(EventID::value<Later>(), EventID::value<Earlier>());
     }
 
     /** \brief add existing event object to queue
@@ -60,7 +125,8 @@ class EventQueue {
     *
     * \param receiver object that will receive events of EventType type
     *
-    * Receiver can be any class. Only requirment is possessing receive(const EventType&) method.
+    * Receiver can be any class. Only requirment is possessing receive(const EventType&) method, or
+    * receiveBatch(EventSpan<EventType>) method, which receives all pending events at once.
     * Receiver will be called every time event of this type will be emited. Single class can receive arbitrary
     * amount of event types.
     */
@@ -80,6 +146,50 @@ class EventQueue {
         getQueue<EventType>()->disconnect(reciever);
     }
 
+    /** \brief sets order in which events of particular type are emitted
+    *
+    * \param comparator returns true if first event should be emitted before second one
+    *
+    * By default events pushed by the same thread are emitted in order of pushing, but order between threads depends
+    * on scheduling. Comparator which defines total order makes emission deterministic. Empty one restores default.
+    */
+    template <typename EventType>
+    void setOrder(std::function<bool(const EventType&, const EventType&)> comparator) {
+        getQueue<EventType>()->setOrder(std::move(comparator));
+    }
+
+    /** \brief allocates memory for variable-sized data of event, for ex. text or list of targets
+    *
+    * \param count number of objects of type T
+    *
+    * Memory comes from linear arena of the calling thread, so it doesn't allocate in steady state, and it's
+    * reclaimed all at once after events of type EventType pushed by this thread are emitted. Objects aren't
+    * destroyed, so T must be trivially destructible. Can be called concurrently.
+    * For ex.
+    * auto targets = events.allocate<ExplosionEvent, EntityID>(hits.size());
+    * std::copy(hits.begin(), hits.end(), targets.begin());
+    * events.emplace<ExplosionEvent>(targets);
+    */
+    template <typename EventType, typename T>
+    EventSpan<T> allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Objects in event arena aren't destroyed!");
+        auto objects = getQueue<EventType>()->template allocate<T>(count);
+        std::uninitialized_fill_n(objects, count, T());
+        return EventSpan<T>(objects, count);
+    }
+
+    // makes buffers of EventType big enough for given number of events, so bursts don't make them grow.
+    template <typename EventType>
+    void reserve(size_t count) {
+        getQueue<EventType>()->reserve(count);
+    }
+
+    // returns statistics of memory used for events of given type, for ex. to find out how much to reserve.
+    template <typename EventType>
+    SingleEventQueueBase::MemoryStatistics memoryStatistics() {
+        return getQueue<EventType>()->memoryStatistics();
+    }
+
     template <typename EventType, typename ReceiverType>
     void setPriority(ReceiverType& obj, int priority) {
         getQueue<EventType>()->disconnect(obj);
@@ -95,6 +205,21 @@ class EventQueue {
    private:
     std::vector<std::unique_ptr<SingleEventQueueBase>> eventQueues;
 
+    ThreadPool* threadPool = nullptr;
+    bool parallelEmit = false;
+
+    // event types which must be emitted before given type, indexed by EventID.
+    std::vector<std::vector<size_t>> predecessors;
+    // event types grouped in waves which can be emitted concurrently, in order of emission. Empty if outdated.
+    std::vector<std::vector<size_t>> waves;
+
+    bool hasPendingEvents();
+    bool addPredecessor(size_t later, size_t earlier);
+    // checks if emission of first type has to wait for second one.
+    bool waitsFor(size_t first, size_t second) const;
+    void computeWaves();
+    void dispatchConcurrently(const std::vector<size_t>& wave);
+
     template <typename EventType>
     SingleEventQueue<EventType>* getQueue() {
         static_assert(std::is_base_of<Event<EventType>, EventType>::value, "Template parameter is not an event!");
@@ -8,6 +8,7 @@ using namespace EECS;
 
 size_t EventID::counter = 0;
 size_t ComponentContainerID::counter = 0;
+size_t ResourceID::counter = 0;
 size_t TaskID::counter = 0;
 
 std::vector<std::unique_ptr<ComponentContainerBase>>& EECS::singleComponentContainerArchetypes() {
@@ -15,6 +16,11 @@ std::vector<std::unique_ptr<ComponentContainerBase>>& EECS::singleComponentConta
     return archetypes;
 };
 
+std::vector<bool>& EECS::changeTrackingComponentTypes() {
+    static std::vector<bool> tracking;
+    return tracking;
+}
+
 std::vector<std::unique_ptr<SingleEventQueueBase>>& EECS::singleEventQueueArchetypes() {
     static std::vector<std::unique_ptr<SingleEventQueueBase>> archetypes;
     return archetypes;
@@ -9,4 +9,7 @@
 namespace EECS {
 std::vector<std::unique_ptr<ComponentContainerBase>>& singleComponentContainerArchetypes();
 std::vector<std::unique_ptr<SingleEventQueueBase>>& singleEventQueueArchetypes();
+
+// flags of component types which track their changes(see Component), indexed by ComponentContainerID.
+std::vector<bool>& changeTrackingComponentTypes();
 }
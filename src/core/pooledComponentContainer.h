@@ -0,0 +1,280 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "componentContainer.h"
+#include "entityID.h"
+
+namespace EECS {
+
+// Component container in which components never move. They are constructed in slots of fixed-size pages, which are
+// reused after deletion and released only when the container is destroyed. Because of that, pointer to a component
+// stays valid as long as the component exists, and its validity can be checked in O(1) without any lookup(see
+// validPointer). Suited for components to which many handles or pointers are held.
+// Entity indices are mapped to slots through paged sparse array, so add, delete and lookup are O(1). Live components
+// are listed in dense vector of pointers for iteration, in unspecified order.
+template <class T>
+class PooledComponentContainer : public ComponentContainerBase {
+    struct Slot;
+
+   public:
+    // view of all live components, which behaves like a vector of components, but its elements are scattered in
+    // memory.
+    class Components {
+       public:
+        class Iterator {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            explicit Iterator(typename std::vector<T*>::const_iterator position) : position(position) {}
+
+            T& operator*() const { return **position; }
+            T* operator->() const { return *position; }
+
+            Iterator& operator++() {
+                ++position;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto previous = *this;
+                ++position;
+                return previous;
+            }
+
+            bool operator==(const Iterator& other) const { return position == other.position; }
+            bool operator!=(const Iterator& other) const { return position != other.position; }
+
+           private:
+            typename std::vector<T*>::const_iterator position;
+        };
+
+        Iterator begin() const { return Iterator(pointers.begin()); }
+        Iterator end() const { return Iterator(pointers.end()); }
+
+        size_t size() const { return pointers.size(); }
+        bool empty() const { return pointers.empty(); }
+
+        T& operator[](size_t index) const { return *pointers[index]; }
+        T& at(size_t index) const {
+            if (index >= pointers.size()) {
+                throw std::out_of_range("PooledComponentContainer::Components::at");
+            }
+            return *pointers[index];
+        }
+
+        T& front() const { return *pointers.front(); }
+        T& back() const { return *pointers.back(); }
+
+       private:
+        std::vector<T*> pointers;
+
+        friend class PooledComponentContainer;
+    };
+
+    PooledComponentContainer() = default;
+    PooledComponentContainer(const PooledComponentContainer&) = delete;
+    PooledComponentContainer& operator=(const PooledComponentContainer&) = delete;
+
+    ~PooledComponentContainer() { clear(); }
+
+    // returns pointer to a component owned by given entity, in O(1). nullptr if component doesn't exist.
+    T* getComponent(EntityID entityID) {
+        auto entry = findEntry(entityID);
+        if (!entry || !*entry || (*entry)->component().entityID != entityID) {
+            return nullptr;
+        }
+
+        return &(*entry)->component();
+    }
+
+    // Returns all components held by this class, in unspecified order. Components can be modified, the returned object
+    // can't.
+    Components& getAllComponents() { return components; }
+
+    // adds new component, replaces existing component if already exists. Arguments after EntityID will be passed
+    // directly to component's constructor. Returns pointer to created component. Replaced component keeps its
+    // address.
+    template <typename... Args>
+    T* addComponent(EntityID entityID, Args&&... args) {
+        if (entityID == 0) {
+            return nullptr;
+        }
+
+        auto& entry = acquireEntry(entityID);
+        if (entry) {
+            auto& component = entry->component();
+            component = T(std::forward<Args>(args)...);
+            component.entityID = entityID;
+            return &component;
+        }
+
+        auto slot = acquireSlot();
+        new (&slot->storage) T(std::forward<Args>(args)...);
+        slot->component().entityID = entityID;
+        slot->alive = true;
+        slot->denseIndex = components.pointers.size();
+        components.pointers.push_back(&slot->component());
+        entry = slot;
+
+        return &slot->component();
+    }
+
+    // adds components to all given entities. Entities must be unique and non-null. Each component is constructed from
+    // args, which are passed by const reference, as they are reused. Existing components are replaced.
+    template <typename... Args>
+    void addComponents(const std::vector<EntityID>& entities, const Args&... args) {
+        components.pointers.reserve(components.pointers.size() + entities.size());
+        for (auto entityID : entities) {
+            addComponent(entityID, args...);
+        }
+    }
+
+    // moves given components into container. Components must belong to unique, non-null entities. Existing components
+    // are replaced.
+    void insertComponents(std::vector<T>& newComponents) {
+        components.pointers.reserve(components.pointers.size() + newComponents.size());
+        for (auto& component : newComponents) {
+            addComponent(component.entityID, std::move(component));
+        }
+    }
+
+    // copies component from one entity to another. Returns true if component was cloned, otherwise false.
+    bool cloneComponent(EntityID sourceEntity, EntityID recipientEntity) override {
+        auto sourceComponent = getComponent(sourceEntity);
+        if (!sourceComponent) {
+            return false;
+        }
+
+        return addComponent(recipientEntity, *sourceComponent) != nullptr;
+    }
+
+    // Deletes component of a given Entity. Other components don't move. Returns true if deleted, false if it doesn't
+    // exist in the first place.
+    bool deleteComponent(EntityID entityID) {
+        auto entry = findEntry(entityID);
+        if (!entry || !*entry || (*entry)->component().entityID != entityID) {
+            return false;
+        }
+
+        releaseSlot(*entry);
+        *entry = nullptr;
+        return true;
+    }
+
+    // used internally as a method to delete all components from given entity.
+    bool genericDeleteComponent(EntityID entityID) override { return deleteComponent(entityID); }
+
+    // deletes components of given entities, in O(k).
+    size_t genericDeleteComponents(const std::vector<EntityID>& entities) override {
+        size_t deleted = 0;
+        for (auto entityID : entities) {
+            deleted += deleteComponent(entityID);
+        }
+
+        return deleted;
+    }
+
+    // Deletes all components. Memory of pages is kept, so pointers to deleted components can still be checked with
+    // validPointer.
+    void clear() override {
+        while (!components.pointers.empty()) {
+            releaseSlot(toSlot(components.pointers.back()));
+        }
+        entries.clear();
+    }
+
+    // checks in O(1) if pointer obtained from this container still points to component of given entity.
+    bool validPointer(const T* componentPtr, EntityID entityID) const {
+        return componentPtr && toSlot(componentPtr)->alive && componentPtr->entityID == entityID;
+    }
+
+    // returns new object of the same class as *this*.
+    std::unique_ptr<ComponentContainerBase> getNewClassInstance() const override {
+        return std::make_unique<PooledComponentContainer<T>>();
+    }
+
+   private:
+    static constexpr size_t slotsPerPage = 256;
+    static constexpr size_t entriesPerPage = 4096;
+
+    struct Slot {
+        // must be first member, so pointer to component is also pointer to its slot.
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        bool alive = false;
+        union {
+            size_t denseIndex;  // position in components, if alive
+            Slot* nextFree;     // next slot in free list, if not alive
+        };
+
+        T& component() { return *reinterpret_cast<T*>(&storage); }
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slotPages;
+    size_t usedSlotsInLastPage = slotsPerPage;
+    Slot* freeSlots = nullptr;
+
+    // paged sparse array mapping entity index to slot of its component, or nullptr.
+    std::vector<std::unique_ptr<Slot* []>> entries;
+    Components components;
+
+    static Slot* toSlot(const T* componentPtr) {
+        return reinterpret_cast<Slot*>(const_cast<T*>(componentPtr));
+    }
+
+    Slot* acquireSlot() {
+        if (freeSlots) {
+            auto slot = freeSlots;
+            freeSlots = slot->nextFree;
+            return slot;
+        }
+
+        if (usedSlotsInLastPage == slotsPerPage) {
+            slotPages.push_back(std::make_unique<Slot[]>(slotsPerPage));
+            usedSlotsInLastPage = 0;
+        }
+
+        return &slotPages.back()[usedSlotsInLastPage++];
+    }
+
+    // destroys component in the slot, removes it from dense list and puts the slot on free list.
+    void releaseSlot(Slot* slot) {
+        auto index = slot->denseIndex;
+        components.pointers[index] = components.pointers.back();
+        toSlot(components.pointers[index])->denseIndex = index;
+        components.pointers.pop_back();
+
+        slot->component().~T();
+        slot->alive = false;
+        slot->nextFree = freeSlots;
+        freeSlots = slot;
+    }
+
+    Slot** findEntry(EntityID entityID) {
+        auto page = entityIndex(entityID) / entriesPerPage;
+        if (page >= entries.size() || !entries[page]) {
+            return nullptr;
+        }
+
+        return &entries[page][entityIndex(entityID) % entriesPerPage];
+    }
+
+    Slot*& acquireEntry(EntityID entityID) {
+        auto page = entityIndex(entityID) / entriesPerPage;
+        if (page >= entries.size()) {
+            entries.resize(page + 1);
+        }
+        if (!entries[page]) {
+            entries[page] = std::make_unique<Slot* []>(entriesPerPage);  // value-initialized, so all are nullptr
+        }
+
+        return entries[page][entityIndex(entityID) % entriesPerPage];
+    }
+};
+}
@@ -0,0 +1,9 @@
+#include "resources.h"
+
+using namespace EECS;
+
+void Resources::clear() {
+    for (auto& resource : resources) {
+        resource.reset();
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+#include <stdexcept>
+#include "componentContainerID.h"
+#include "componentAccess.h"
+
+namespace EECS {
+/** \brief typed registry of global state, like camera, time or input
+*
+* Each resource type has at most one instance, stored in slot indexed by ResourceID, so it's accessed in O(1) without
+* any entity. Any type can be a resource, it doesn't derive from Component.
+*
+* Usage:
+* ecs.resources.set<FrameTime>(16ms);
+* ecs.resources.get<FrameTime>()->delta; // nullptr if FrameTime isn't set
+*
+* Tasks declare resources they use alongside component types, for ex. Task<Physics, Reads<FrameTime>,
+* Writes<Position>>, so TaskScheduler doesn't update Tasks writing a resource concurrently with ones using it. Like
+* with components, accesses are validated against these declarations in debug builds, and const-qualified type is the
+* same resource as the type itself: get<const Camera>() returns pointer to const Camera, and is validated as read.
+*
+* Setting or removing resource concurrently with accessing the same resource type is a data race, so it should be
+* done only by Tasks which declare writing it, or outside of TaskScheduler::update.
+*/
+class Resources {
+   public:
+    Resources() : resources(maxResourceTypes) {}
+
+    // creates resource of type T from given arguments, replaces existing one. Returns reference to it.
+    template <class T, class... Args>
+    T& set(Args&&... args) {
+        static_assert(!std::is_const<T>::value, "Set resource type can't be const-qualified!");
+        auto& slot = resources[idOf<T>(true)];
+        slot = std::make_unique<Holder<T>>(std::forward<Args>(args)...);
+        return static_cast<Holder<T>&>(*slot).value;
+    }
+
+    // returns pointer to resource of type T, or nullptr if it isn't set. Pointer is to const if T is const-qualified.
+    template <class T>
+    T* get() {
+        auto& slot = resources[idOf<T>(false)];
+        return slot ? &static_cast<Holder<std::remove_cv_t<T>>&>(*slot).value : nullptr;
+    }
+
+    // the same as get, but in debug builds it's validated as write, against access declared by Task.
+    template <class T>
+    T* modify() {
+        static_assert(!std::is_const<T>::value, "Modified resource type can't be const-qualified!");
+        auto& slot = resources[idOf<T>(true)];
+        return slot ? &static_cast<Holder<T>&>(*slot).value : nullptr;
+    }
+
+    template <class T>
+    bool has() {
+        return get<T>() != nullptr;
+    }
+
+    // destroys resource of type T. Returns false if it wasn't set.
+    template <class T>
+    bool remove() {
+        auto& slot = resources[idOf<T>(true)];
+        auto existed = slot != nullptr;
+        slot.reset();
+        return existed;
+    }
+
+    // destroys all resources.
+    void clear();
+
+   private:
+    struct ResourceBase {
+        virtual ~ResourceBase() {}
+    };
+
+    template <class T>
+    struct Holder : ResourceBase {
+        template <class... Args>
+        Holder(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+        T value;
+    };
+
+    std::vector<std::unique_ptr<ResourceBase>> resources;
+
+    // write should be true if caller is about to modify the resource. It's used to validate access declared by Tasks
+    // in debug builds. Throws std::length_error if there are more resource types than maxResourceTypes, in every
+    // build, as storage can't grow without invalidating resources accessed concurrently.
+    template <class T>
+    static size_t idOf(bool write) {
+        auto id = ResourceID::get<T>();
+        if (id >= maxResourceTypes) {
+            throw std::length_error("Too many resource types, increase maxResourceTypes!");
+        }
+#ifndef NDEBUG
+        ComponentAccess::validateResource(id, write);
+#else
+        (void)write;
+#endif
+        return id;
+    }
+};
+}
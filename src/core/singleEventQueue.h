@@ -1,71 +1,299 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include "FastDelegate.h"
+#include "arena.h"
+#include "threadLocalSlots.h"
 
 namespace EECS {
-class SingleEventQueueBase {
+// Receiver type can declare `static constexpr bool threadSafeReceiver = true;` if its receive methods can be called
+// concurrently, for different event types. Only event types whose all receivers are thread-safe are emitted on worker
+// threads(see EventQueue::setParallelEmit), others are emitted on thread which calls EventQueue::emit.
+template <class ReceiverType, class = void>
+struct IsThreadSafeReceiver : std::false_type {};
+
+template <class ReceiverType>
+struct IsThreadSafeReceiver<ReceiverType, std::enable_if_t<ReceiverType::threadSafeReceiver>> : std::true_type {};
+
+/** \brief contiguous range of events, passed to receivers which receive events in batches
+*
+* Receiver opts in by defining `void receiveBatch(EventSpan<EventType> events)` instead of receive(EventType&), and
+* gets all pending events of that type in single call. Also used for variable-sized data of events, allocated with
+* EventQueue::allocate.
+*/
+template <class EventType>
+class EventSpan {
    public:
-    virtual void emit() = 0;
+    EventSpan() : first(nullptr), count(0) {}
+    EventSpan(EventType* first, size_t count) : first(first), count(count) {}
+
+    EventType* begin() const { return first; }
+    EventType* end() const { return first + count; }
+    EventType* data() const { return first; }
 
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    EventType& operator[](size_t index) const { return first[index]; }
+
+   private:
+    EventType* first;
+    size_t count;
+};
+
+template <class ReceiverType, class EventType, class = void>
+struct ReceivesBatches : std::false_type {};
+
+template <class ReceiverType, class EventType>
+struct ReceivesBatches<ReceiverType, EventType,
+                       decltype((void)std::declval<ReceiverType&>().receiveBatch(std::declval<EventSpan<EventType>>()))>
+    : std::true_type {};
+
+class SingleEventQueueBase {
+   public:
     virtual ~SingleEventQueueBase() {}
 
+    // emits pending events.
+    void emit() {
+        collect();
+        dispatch();
+    }
+
+    // moves events pushed so far into queue of events to dispatch. Must not be called concurrently with pushing.
+    virtual void collect() = 0;
+
+    // passes collected events to receivers. Events pushed meanwhile are kept for the next collect().
+    virtual void dispatch() = 0;
+
+    // checks if all connected receivers are thread-safe.
+    virtual bool threadSafe() const = 0;
+
+    // checks if any events were pushed since last collect(). Must not be called concurrently with pushing.
+    virtual bool hasPendingEvents() = 0;
+
+    // memory used for events of this type.
+    struct MemoryStatistics {
+        // the most events emitted by single emit() call.
+        size_t eventsHighWaterMark = 0;
+        // number of events which fit in buffers without allocating.
+        size_t eventsCapacity = 0;
+        // the most bytes of data allocated by single thread for events emitted by single emit() call.
+        size_t arenaHighWaterMark = 0;
+        // bytes owned by arenas of all threads.
+        size_t arenaCapacity = 0;
+    };
+
+    virtual MemoryStatistics memoryStatistics() = 0;
+
     virtual std::unique_ptr<SingleEventQueueBase> getNewClassInstance() const = 0;
 
     virtual void clear() = 0;
+
+   protected:
+    // finds staging buffer of calling thread.
+    ThreadLocalSlots threadStagings;
 };
 
+/** \brief pending events of single type, with receivers connected to them
+*
+* Events can be pushed concurrently from many threads(for ex. by Tasks updated concurrently, or their workers) without
+* blocking each other: every thread pushes to its own staging buffer, found through ThreadLocalSlots, like in
+* CommandBuffer. Buffers are merged when events are emitted. Events pushed by one thread are emitted in order of
+* pushing, but order between threads depends on scheduling, unless order of events is set(see setOrder).
+*
+* emit() must not be called concurrently with pushing. Events pushed by receivers during emit() are emitted by the
+* next emit() call. It consists of collect(), which merges staging buffers, and dispatch(), so EventQueue can collect
+* all types first, and then dispatch them concurrently.
+*
+* Receivers which define receiveBatch(EventSpan<EventType>) get all events in one call, instead of call per event. If
+* any of them is connected, receivers are called one after another in order of priority, each with all events, and
+* events rejected by receive(EventType&) are removed from span passed to further ones. Otherwise, each event is
+* passed through all receivers before the next one.
+*
+* Memory for events is recycled: buffers keep their capacity, and variable-sized data of events is allocated from
+* per-thread linear arenas(see allocate), reset in O(1) after events are dispatched. Every thread has two arenas, used
+* alternately by consecutive emissions, so data of events pushed during dispatch survives until they are emitted.
+* Once buffers and arenas reach their high-water marks(see memoryStatistics), the event path doesn't allocate.
+*/
 template <typename EventType>
 class SingleEventQueue : public SingleEventQueueBase {
     struct DelegateEntry {
+        // exactly one of delegates is set, depending on whether receiver receives batches.
         fastdelegate::FastDelegate1<EventType&, bool> delegate;
+        fastdelegate::FastDelegate1<EventSpan<EventType>> batchDelegate;
         int priority;
+        bool threadSafe;
+
+        bool sameReceiver(const DelegateEntry& other) const {
+            return delegate == other.delegate && batchDelegate == other.batchDelegate;
+        }
     };
 
    public:
-    void emit() override {
-        for (auto& event : events) {
-            for (auto& delegate : delegates) {
-                if (!delegate.delegate(event)) {
-                    break;
-                }
+    void collect() override {
+        // staging buffers are kept with their capacity, so pushing doesn't allocate in steady state
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        for (auto& staging : stagings) {
+            std::move(staging->events.begin(), staging->events.end(), std::back_inserter(events));
+            staging->events.clear();
+        }
+
+        // data of collected events is in arenas of current epoch, so new events use the other ones
+        dispatchedEpoch = epoch;
+        epoch = 1 - epoch;
+    }
+
+    void dispatch() override {
+        if (!events.empty()) {
+            if (order) {
+                std::stable_sort(events.begin(), events.end(), order);
+            }
+
+            auto batched = std::any_of(delegates.begin(), delegates.end(),
+                                       [](const DelegateEntry& delegate) { return !delegate.batchDelegate.empty(); });
+            if (batched) {
+                dispatchByReceivers();
+            } else {
+                dispatchByEvents();
             }
+
+            eventsHighWaterMark = std::max(eventsHighWaterMark, events.size());
+            events.clear();
         }
-        events.clear();
+
+        // data of dispatched events isn't needed anymore
+
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        for (auto& staging : stagings) {
+            staging->arenas[dispatchedEpoch].reset();
+        }
+    }
+
+    // returns uninitialized memory for count objects of type T, which stays valid until events pushed by the calling
+    // thread are dispatched. Can be called concurrently.
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(localStaging().arenas[epoch].allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // makes buffers big enough for given number of events, so they don't grow during bursts. Buffer of the calling
+    // thread is reserved, as well as buffer of events being emitted.
+    void reserve(size_t count) {
+        localStaging().events.reserve(count);
+        events.reserve(count);
     }
 
-    void push(EventType&& event) { events.push_back(std::move(event)); }
+    // can be called concurrently. In immediate mode, event is dispatched right away instead.
+    void push(EventType&& event) {
+        if (immediate) {
+            dispatchNow(event);
+            return;
+        }
+
+        localStaging().events.push_back(std::move(event));
+    }
 
+    // can be called concurrently. In immediate mode, event is dispatched right away instead.
     template <typename... Args>
     void emplace(Args&&... args) {
-        events.emplace_back(std::forward<Args>(args)...);
+        if (immediate) {
+            EventType event(std::forward<Args>(args)...);
+            dispatchNow(event);
+            return;
+        }
+
+        localStaging().events.emplace_back(std::forward<Args>(args)...);
     }
 
+    // passes event to receivers right away, on calling thread, without queueing it. Batch receivers get span of this
+    // single event.
+    void dispatchNow(EventType& event) {
+        for (auto& delegate : delegates) {
+            if (!delegate.batchDelegate.empty()) {
+                delegate.batchDelegate(EventSpan<EventType>(&event, 1));
+            } else if (!delegate.delegate(event)) {
+                break;
+            }
+        }
+    }
+
+    // makes push and emplace dispatch events right away, see dispatchNow.
+    void setImmediate(bool immediate) { this->immediate = immediate; }
+
+    // makes events emitted in order given by comparator, which makes it independent of threads which pushed them, if
+    // comparator defines total order. Events which are equivalent keep order of pushing only if pushed by the same
+    // thread. Empty function restores default order.
+    void setOrder(std::function<bool(const EventType&, const EventType&)> comparator) { order = std::move(comparator); }
+
     template <typename ObjectType>
     void connect(ObjectType& obj, int priority) {
-        auto alreadyConnected = std::find_if(delegates.begin(), delegates.end(), [&obj](DelegateEntry& delegateEntry) {
-            return delegateEntry.delegate == fastdelegate::FastDelegate1<EventType&, bool>{&obj, &ObjectType::receive};
-        });
+        auto entry = makeEntry(obj, ReceivesBatches<ObjectType, EventType>{});
+        auto alreadyConnected =
+            std::find_if(delegates.begin(), delegates.end(),
+                         [&entry](const DelegateEntry& delegateEntry) { return delegateEntry.sameReceiver(entry); });
         if (alreadyConnected != delegates.end()) {
             return;
         }
 
+        entry.priority = priority;
         auto place = std::lower_bound(delegates.begin(), delegates.end(), priority,
                                       [](const auto& delegate, int priority) { return delegate.priority < priority; });
-        delegates.insert(place, {fastdelegate::FastDelegate1<EventType&, bool>{&obj, &ObjectType::receive}, priority});
+        delegates.insert(place, entry);
     }
 
     template <typename ObjectType>
     void disconnect(ObjectType& obj) {
-        auto delegateIt = std::find_if(delegates.begin(), delegates.end(), [&obj](DelegateEntry& delegateEntry) {
-            return delegateEntry.delegate == fastdelegate::FastDelegate1<EventType&, bool>{&obj, &ObjectType::receive};
-        });
+        auto entry = makeEntry(obj, ReceivesBatches<ObjectType, EventType>{});
+        auto delegateIt =
+            std::find_if(delegates.begin(), delegates.end(),
+                         [&entry](const DelegateEntry& delegateEntry) { return delegateEntry.sameReceiver(entry); });
 
         if (delegateIt != delegates.end()) {
             delegates.erase(delegateIt);
         }
     }
 
+    bool hasPendingEvents() override {
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        return std::any_of(stagings.begin(), stagings.end(),
+                           [](const std::unique_ptr<Staging>& staging) { return !staging->events.empty(); });
+    }
+
+    MemoryStatistics memoryStatistics() override {
+        MemoryStatistics statistics;
+        statistics.eventsHighWaterMark = eventsHighWaterMark;
+        statistics.eventsCapacity = events.capacity();
+
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        for (auto& staging : stagings) {
+            statistics.eventsCapacity += staging->events.capacity();
+            for (auto& arena : staging->arenas) {
+                statistics.arenaHighWaterMark = std::max(statistics.arenaHighWaterMark, arena.highWaterMark());
+                statistics.arenaCapacity += arena.capacity();
+            }
+        }
+
+        return statistics;
+    }
+
+    bool threadSafe() const override {
+        return std::all_of(delegates.begin(), delegates.end(),
+                           [](const DelegateEntry& delegate) { return delegate.threadSafe; });
+    }
+
     void clear() override {
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        for (auto& staging : stagings) {
+            staging->events.clear();
+            for (auto& arena : staging->arenas) {
+                arena.reset();
+            }
+        }
         events.clear();
         delegates.clear();
     }
@@ -77,6 +305,76 @@ class SingleEventQueue : public SingleEventQueueBase {
 
    private:
     std::vector<DelegateEntry> delegates;
+    // events being emitted, merged from staging buffers.
     std::vector<EventType> events;
+    std::function<bool(const EventType&, const EventType&)> order;
+    bool immediate = false;
+    size_t eventsHighWaterMark = 0;
+
+    // events pushed by single thread, and arenas for their data.
+    struct Staging {
+        std::vector<EventType> events;
+        LinearArena arenas[2];
+    };
+
+    std::mutex stagingsMutex;
+    std::vector<std::unique_ptr<Staging>> stagings;
+    // index of arenas used by pushed events. Changed only by collect(), which isn't concurrent with pushing.
+    size_t epoch = 0;
+    // index of arenas used by events being dispatched.
+    size_t dispatchedEpoch = 0;
+
+    template <typename ObjectType>
+    static DelegateEntry makeEntry(ObjectType& obj, std::false_type) {
+        return {{&obj, &ObjectType::receive}, {}, 0, IsThreadSafeReceiver<ObjectType>::value};
+    }
+
+    template <typename ObjectType>
+    static DelegateEntry makeEntry(ObjectType& obj, std::true_type) {
+        return {{}, {&obj, &ObjectType::receiveBatch}, 0, IsThreadSafeReceiver<ObjectType>::value};
+    }
+
+    void dispatchByEvents() {
+        for (auto& event : events) {
+            for (auto& delegate : delegates) {
+                if (!delegate.delegate(event)) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // calls receivers one after another. Events rejected by a receiver are removed, keeping order of remaining ones.
+    void dispatchByReceivers() {
+        auto remaining = events.size();
+        for (auto& delegate : delegates) {
+            if (!delegate.batchDelegate.empty()) {
+                delegate.batchDelegate(EventSpan<EventType>(events.data(), remaining));
+                continue;
+            }
+
+            size_t kept = 0;
+            for (size_t i = 0; i < remaining; i++) {
+                if (delegate.delegate(events[i])) {
+                    if (kept != i) {
+                        events[kept] = std::move(events[i]);
+                    }
+                    kept++;
+                }
+            }
+            remaining = kept;
+        }
+    }
+
+    Staging& localStaging() {
+        if (auto staging = threadStagings.find()) {
+            return *static_cast<Staging*>(staging);
+        }
+
+        std::lock_guard<std::mutex> lock(stagingsMutex);
+        stagings.push_back(std::make_unique<Staging>());
+        threadStagings.add(stagings.back().get());
+        return *stagings.back();
+    }
 };
 }
@@ -0,0 +1,425 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include "componentContainer.h"
+#include "alignedAllocator.h"
+#include "entityID.h"
+
+namespace EECS {
+template <class T>
+class SoAComponentContainer;
+
+namespace detail {
+// maps tuple of member pointers returned by T::fields() to tuple of vectors, one for each field.
+template <class MemberPointers>
+struct SoAColumns;
+
+template <class T, class... Fields>
+struct SoAColumns<std::tuple<Fields T::*...>> {
+    using type = std::tuple<AlignedVector<Fields>...>;
+};
+}
+
+// Reference to a component stored in SoAComponentContainer. Fields of the component aren't stored together, so it
+// can't be accessed through T& - SoAReference gives access to fields one by one, or loads/stores whole component.
+// Like pointers to components in SortedStorage, it's invalidated by adding or deleting any component of this type.
+// Default constructed reference is null.
+// For ex.
+// auto position = components.getComponent<Position>(entity);
+// position.get<0>() += 5.0f;                  // modifies x in place, if fields() returns (&Position::x, &Position::y)
+// Position copy = position.load();             // gathers all fields
+template <class T>
+class SoAReference {
+   public:
+    SoAReference() = default;
+    SoAReference(std::nullptr_t) {}
+
+    explicit operator bool() const { return container != nullptr; }
+    bool operator==(std::nullptr_t) const { return container == nullptr; }
+    bool operator!=(std::nullptr_t) const { return container != nullptr; }
+
+    EntityID entityID() const { return container->entities[index]; }
+
+    // returns reference to field with given index in T::fields().
+    template <size_t FieldIndex>
+    auto& get() const {
+        return std::get<FieldIndex>(container->columns)[index];
+    }
+
+    // returns copy of the component, gathered from all fields.
+    T load() const { return container->load(index); }
+
+    // overwrites all fields of the component, except entityID.
+    void store(const T& component) const { container->store(index, component); }
+
+   private:
+    SoAComponentContainer<T>* container = nullptr;
+    size_t index = 0;
+
+    SoAReference(SoAComponentContainer<T>* container, size_t index) : container(container), index(index) {}
+
+    friend class SoAComponentContainer<T>;
+};
+
+// Component container with structure-of-arrays layout: each field listed by component's static fields() method is
+// kept in separate contiguous vector, and entity ids in yet another one. All of them are sorted by entity id, like in
+// ComponentContainer. Code which processes only some fields doesn't drag the others through the cache, and field
+// arrays can be consumed directly by vectorized loops(see fieldArray).
+// Only the listed fields are stored - the component object exists only during construction, in load() and store().
+// Component must be default constructible and copy assignable.
+template <class T>
+class SoAComponentContainer : public ComponentContainerBase {
+    using Columns = typename detail::SoAColumns<decltype(T::fields())>::type;
+    using FieldIndices = std::make_index_sequence<std::tuple_size<Columns>::value>;
+
+   public:
+    static_assert(std::is_default_constructible<T>::value, "Components stored as SoA must be default constructible!");
+
+    // range over all components, in order of entity ids. Elements are SoAReferences.
+    class Components {
+       public:
+        class Iterator {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = SoAReference<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = SoAReference<T>;
+
+            Iterator(SoAComponentContainer* container, size_t index) : container(container), index(index) {}
+
+            SoAReference<T> operator*() const { return SoAReference<T>(container, index); }
+
+            Iterator& operator++() {
+                index++;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto previous = *this;
+                index++;
+                return previous;
+            }
+
+            bool operator==(const Iterator& other) const { return index == other.index; }
+            bool operator!=(const Iterator& other) const { return index != other.index; }
+
+           private:
+            SoAComponentContainer* container;
+            size_t index;
+        };
+
+        Iterator begin() const { return Iterator(container, 0); }
+        Iterator end() const { return Iterator(container, size()); }
+
+        size_t size() const { return container->entities.size(); }
+        bool empty() const { return container->entities.empty(); }
+
+        SoAReference<T> operator[](size_t index) const { return SoAReference<T>(container, index); }
+        SoAReference<T> at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("SoAComponentContainer::Components::at");
+            }
+            return SoAReference<T>(container, index);
+        }
+
+        // entity ids of components, sorted.
+        const std::vector<EntityID>& entities() const { return container->entities; }
+
+        // returns pointer to contiguous array of values of field with given index in T::fields(), size() elements
+        // long, aligned to componentAlignment bytes. Elements can be modified.
+        template <size_t FieldIndex>
+        auto fieldArray() const {
+            return std::get<FieldIndex>(container->columns).data();
+        }
+
+        // consecutive components, starting at some index. Handed out by ComponentManager::forEachChunk.
+        class Chunk {
+           public:
+            // returns pointer to values of field with given index, starting at first component of the chunk.
+            template <size_t FieldIndex>
+            auto field() const {
+                return components.template fieldArray<FieldIndex>() + begin;
+            }
+
+            const EntityID* entities() const { return components.entities().data() + begin; }
+
+           private:
+            const Components& components;
+            size_t begin;
+
+            Chunk(const Components& components, size_t begin) : components(components), begin(begin) {}
+
+            friend class Components;
+        };
+
+        // returns chunk starting at component with given index.
+        Chunk chunk(size_t begin) const { return Chunk(*this, begin); }
+
+       private:
+        SoAComponentContainer* container;
+
+        explicit Components(SoAComponentContainer* container) : container(container) {}
+
+        friend class SoAComponentContainer;
+    };
+
+    SoAComponentContainer() : components(this) {}
+    SoAComponentContainer(const SoAComponentContainer&) = delete;
+    SoAComponentContainer& operator=(const SoAComponentContainer&) = delete;
+
+    // returns reference to a component owned by given entity, in O(lg n). Null reference if component doesn't exist.
+    SoAReference<T> getComponent(EntityID entityID) {
+        auto place = std::lower_bound(entities.begin(), entities.end(), entityID);
+        if (place == entities.end() || *place != entityID) {
+            return nullptr;
+        }
+
+        return SoAReference<T>(this, place - entities.begin());
+    }
+
+    // Returns all components held by this class. See Components.
+    Components& getAllComponents() { return components; }
+
+    // adds new component, replaces existing component if already exists. Arguments after EntityID will be passed
+    // directly to component's constructor, then fields are scattered into arrays. Returns reference to the component.
+    template <typename... Args>
+    SoAReference<T> addComponent(EntityID entityID, Args&&... args) {
+        if (entityID == 0) {
+            return nullptr;
+        }
+
+        // constructed before insertion, as args may reference component of this container(like in cloning).
+        T component(std::forward<Args>(args)...);
+
+        auto place = std::lower_bound(entities.begin(), entities.end(), entityID);
+        auto index = (size_t)(place - entities.begin());
+        if (place == entities.end() || *place != entityID) {
+            entities.insert(place, entityID);
+            insertDefault(index, FieldIndices{});
+        }
+
+        store(index, component);
+        return SoAReference<T>(this, index);
+    }
+
+    // adds components to all given entities, in single pass. Entities must be sorted, unique and non-null.
+    // Each component is constructed from args, which are passed by const reference, as they are reused. Existing
+    // components are replaced.
+    template <typename... Args>
+    void addComponents(const std::vector<EntityID>& sortedEntities, const Args&... args) {
+        std::vector<T> newComponents(sortedEntities.size(), T(args...));
+        for (size_t i = 0; i < sortedEntities.size(); i++) {
+            newComponents[i].entityID = sortedEntities[i];
+        }
+
+        insertComponents(newComponents);
+    }
+
+    // copies fields of given components into container, in single pass. Components must be sorted by entityID, and
+    // belong to unique, non-null entities. Existing components are replaced.
+    void insertComponents(std::vector<T>& sortedComponents) {
+        auto oldSize = entities.size();
+        size_t existing = 0;
+
+        for (const auto& component : sortedComponents) {
+            existing = std::lower_bound(entities.begin() + existing, entities.begin() + oldSize, component.entityID) -
+                       entities.begin();
+
+            if (existing == oldSize || entities[existing] != component.entityID) {
+                entities.push_back(component.entityID);
+                insertDefault(entities.size() - 1, FieldIndices{});
+                store(entities.size() - 1, component);
+            } else {
+                store(existing, component);
+            }
+        }
+
+        if (entities.size() == oldSize) {
+            return;
+        }
+
+        // both parts are sorted, so they are merged by computing order once and permuting every array with it
+        std::vector<size_t> order(entities.size());
+        std::merge(IndexIterator(0), IndexIterator(oldSize), IndexIterator(oldSize), IndexIterator(entities.size()),
+                   order.begin(), [this](size_t a, size_t b) { return entities[a] < entities[b]; });
+        permute(entities, order);
+        permuteColumns(order, FieldIndices{});
+    }
+
+    // copies component from one entity to another. Returns true if component was cloned, otherwise false.
+    bool cloneComponent(EntityID sourceEntity, EntityID recipientEntity) override {
+        auto sourceComponent = getComponent(sourceEntity);
+        if (!sourceComponent) {
+            return false;
+        }
+
+        return (bool)addComponent(recipientEntity, sourceComponent.load());
+    }
+
+    // Deletes component of a given Entity. Returns true if deleted, false if it doesn't exist in the first place.
+    bool deleteComponent(EntityID entityID) {
+        auto place = std::lower_bound(entities.begin(), entities.end(), entityID);
+        if (place == entities.end() || *place != entityID) {
+            return false;
+        }
+
+        auto index = place - entities.begin();
+        entities.erase(place);
+        eraseColumns(index, FieldIndices{});
+        return true;
+    }
+
+    // used internally as a method to delete all components from given entity.
+    bool genericDeleteComponent(EntityID entityID) override { return deleteComponent(entityID); }
+
+    // deletes components of given entities in single compaction pass, in O(n + k).
+    size_t genericDeleteComponents(const std::vector<EntityID>& sortedEntities) override {
+        std::vector<bool> keep(entities.size(), true);
+        size_t deleted = 0;
+        auto searchStart = entities.begin();
+        for (auto entityID : sortedEntities) {
+            searchStart = std::lower_bound(searchStart, entities.end(), entityID);
+            if (searchStart != entities.end() && *searchStart == entityID) {
+                keep[searchStart - entities.begin()] = false;
+                deleted++;
+            }
+        }
+
+        if (deleted) {
+            compact(entities, keep);
+            compactColumns(keep, FieldIndices{});
+        }
+
+        return deleted;
+    }
+
+    // Deletes all components
+    void clear() override {
+        entities.clear();
+        clearColumns(FieldIndices{});
+    }
+
+    // returns new object of the same class as *this*.
+    std::unique_ptr<ComponentContainerBase> getNewClassInstance() const override {
+        return std::make_unique<SoAComponentContainer<T>>();
+    }
+
+   private:
+    std::vector<EntityID> entities;
+    Columns columns;
+    Components components;
+
+    // iterates over indices, used to merge index ranges without materializing them.
+    class IndexIterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = size_t;
+
+        explicit IndexIterator(size_t index) : index(index) {}
+
+        size_t operator*() const { return index; }
+        IndexIterator& operator++() {
+            index++;
+            return *this;
+        }
+        IndexIterator operator++(int) { return IndexIterator(index++); }
+
+        bool operator==(const IndexIterator& other) const { return index == other.index; }
+        bool operator!=(const IndexIterator& other) const { return index != other.index; }
+
+       private:
+        size_t index;
+    };
+
+    T load(size_t index) const { return load(index, FieldIndices{}); }
+
+    template <size_t... Indices>
+    T load(size_t index, std::index_sequence<Indices...>) const {
+        T component;
+        auto fields = T::fields();
+        (void)fields;  // unused by components without fields
+        (void)std::initializer_list<int>{
+            (component.*std::get<Indices>(fields) = std::get<Indices>(columns)[index], 0)...};
+        component.entityID = entities[index];
+        return component;
+    }
+
+    void store(size_t index, const T& component) { store(index, component, FieldIndices{}); }
+
+    template <size_t... Indices>
+    void store(size_t index, const T& component, std::index_sequence<Indices...>) {
+        auto fields = T::fields();
+        (void)fields;
+        (void)std::initializer_list<int>{
+            (std::get<Indices>(columns)[index] = component.*std::get<Indices>(fields), 0)...};
+    }
+
+    template <size_t... Indices>
+    void insertDefault(size_t index, std::index_sequence<Indices...>) {
+        (void)index;
+        (void)std::initializer_list<int>{
+            (std::get<Indices>(columns).emplace(std::get<Indices>(columns).begin() + index), 0)...};
+    }
+
+    template <size_t... Indices>
+    void eraseColumns(size_t index, std::index_sequence<Indices...>) {
+        (void)index;
+        (void)std::initializer_list<int>{
+            (std::get<Indices>(columns).erase(std::get<Indices>(columns).begin() + index), 0)...};
+    }
+
+    template <size_t... Indices>
+    void clearColumns(std::index_sequence<Indices...>) {
+        (void)std::initializer_list<int>{(std::get<Indices>(columns).clear(), 0)...};
+    }
+
+    template <size_t... Indices>
+    void permuteColumns(const std::vector<size_t>& order, std::index_sequence<Indices...>) {
+        (void)order;
+        (void)std::initializer_list<int>{(permute(std::get<Indices>(columns), order), 0)...};
+    }
+
+    template <size_t... Indices>
+    void compactColumns(const std::vector<bool>& keep, std::index_sequence<Indices...>) {
+        (void)keep;
+        (void)std::initializer_list<int>{(compact(std::get<Indices>(columns), keep), 0)...};
+    }
+
+    // reorders values, so that i-th value becomes values[order[i]].
+    template <class Values>
+    static void permute(Values& values, const std::vector<size_t>& order) {
+        Values permuted;
+        permuted.reserve(values.size());
+        for (auto index : order) {
+            permuted.push_back(std::move(values[index]));
+        }
+        values = std::move(permuted);
+    }
+
+    // removes values which aren't marked to keep, preserving order of the rest.
+    template <class Values>
+    static void compact(Values& values, const std::vector<bool>& keep) {
+        size_t kept = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (keep[i]) {
+                values[kept++] = std::move(values[i]);
+            }
+        }
+        values.resize(kept);
+    }
+
+    friend class SoAReference<T>;
+};
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include "componentContainer.h"
+#include "entityID.h"
+
+namespace EECS {
+
+// Component container based on sparse set. Entity indices(see entityIndex) are mapped through paged sparse array to
+// slots of densely packed vector of components. Add, delete and lookup are O(1), but order of components in the dense
+// vector is unspecified - deletion moves last component into the freed slot(swap-and-pop).
+// Only one generation of given entity index can own a component at a time - adding component for a newer generation
+// replaces component of the stale one.
+template <class T>
+class SparseComponentContainer : public ComponentContainerBase {
+   public:
+    // returns pointer to a component owned by given entity, in O(1). nullptr if component doesn't exist.
+    T* getComponent(EntityID entityID) {
+        auto slot = findSlot(entityID);
+        if (!slot || *slot == 0 || components[*slot - 1].entityID != entityID) {
+            return nullptr;
+        }
+
+        return &components[*slot - 1];
+    }
+
+    // Returns all components held by this class, in unspecified order. Same restrictions as in
+    // ComponentContainer::getAllComponents apply - the vector itself shouldn't be modified.
+    AlignedVector<T>& getAllComponents() { return components; }
+
+    // adds new component, replaces existing component if already exists. Arguments after EntityID will be passed
+    // directly to component's constructor. Returns pointer to created component.
+    template <typename... Args>
+    T* addComponent(EntityID entityID, Args&&... args) {
+        if (entityID == 0) {
+            return nullptr;
+        }
+
+        auto& slot = acquireSlot(entityID);
+        if (slot != 0) {
+            auto& component = components[slot - 1];
+            component = T(std::forward<Args>(args)...);
+            component.entityID = entityID;
+            return &component;
+        }
+
+        // temporary is created before push_back, so args referencing components(like in cloning) stay valid.
+        components.push_back(T(std::forward<Args>(args)...));
+        components.back().entityID = entityID;
+        slot = (uint32_t)components.size();
+
+        return &components.back();
+    }
+
+    // adds components to all given entities. Entities must be unique and non-null. Each component is constructed from
+    // args, which are passed by const reference, as they are reused. Existing components are replaced.
+    template <typename... Args>
+    void addComponents(const std::vector<EntityID>& entities, const Args&... args) {
+        components.reserve(components.size() + entities.size());
+        for (auto entityID : entities) {
+            addComponent(entityID, args...);
+        }
+    }
+
+    // moves given components into container. Components must belong to unique, non-null entities. Existing components
+    // are replaced.
+    void insertComponents(std::vector<T>& newComponents) {
+        components.reserve(components.size() + newComponents.size());
+        for (auto& component : newComponents) {
+            auto entityID = component.entityID;
+            auto& slot = acquireSlot(entityID);
+            if (slot != 0) {
+                components[slot - 1] = std::move(component);
+            } else {
+                components.push_back(std::move(component));
+                slot = (uint32_t)components.size();
+            }
+            components[slot - 1].entityID = entityID;
+        }
+    }
+
+    // copies component from one entity to another. Returns true if component was cloned, otherwise false.
+    bool cloneComponent(EntityID sourceEntity, EntityID recipientEntity) override {
+        auto sourceComponent = getComponent(sourceEntity);
+        if (!sourceComponent) {
+            return false;
+        }
+
+        return addComponent(recipientEntity, *sourceComponent) != nullptr;
+    }
+
+    // Deletes component of a given Entity. Last component is moved into its place, so pointers to it are invalidated.
+    // Returns true if deleted, false if it doesn't exist in the first place.
+    bool deleteComponent(EntityID entityID) {
+        auto slot = findSlot(entityID);
+        if (!slot || *slot == 0 || components[*slot - 1].entityID != entityID) {
+            return false;
+        }
+
+        auto index = *slot - 1;
+        *slot = 0;
+
+        if (index != components.size() - 1) {
+            components[index] = std::move(components.back());
+            *findSlot(components[index].entityID) = index + 1;
+        }
+        components.pop_back();
+
+        return true;
+    }
+
+    // moves components of given entities to the beginning of dense vector, in given order, swapping them with ones
+    // which were there. Entities must be unique, ones without component are skipped. Returns number of moved
+    // components, so components of the first n given entities which have one are the first n components.
+    size_t orderBy(const std::vector<EntityID>& entities) {
+        size_t position = 0;
+        for (auto entityID : entities) {
+            auto component = getComponent(entityID);
+            if (!component) {
+                continue;
+            }
+
+            auto index = (size_t)(component - components.data());
+            if (index != position) {
+                std::swap(components[index], components[position]);
+                *findSlot(components[index].entityID) = (uint32_t)index + 1;
+                *findSlot(components[position].entityID) = (uint32_t)position + 1;
+            }
+            position++;
+        }
+
+        return position;
+    }
+
+    // checks if pointer obtained from this container still points to component of given entity, in O(1). Pointers
+    // can be invalidated by adding or deleting any component of this type, as the vector moves its elements.
+    bool validPointer(const T* componentPtr, EntityID entityID) const {
+        return !components.empty() && !std::less<const T*>()(componentPtr, &components.front()) &&
+               !std::less<const T*>()(&components.back(), componentPtr) && componentPtr->entityID == entityID;
+    }
+
+    // used internally as a method to delete all components from given entity.
+    bool genericDeleteComponent(EntityID entityID) override { return deleteComponent(entityID); }
+
+    // deletes components of given entities, in O(k).
+    size_t genericDeleteComponents(const std::vector<EntityID>& entities) override {
+        size_t deleted = 0;
+        for (auto entityID : entities) {
+            deleted += deleteComponent(entityID);
+        }
+
+        return deleted;
+    }
+
+    // Deletes all components
+    void clear() override {
+        components.clear();
+        pages.clear();
+    }
+
+    // returns new object of the same class as *this*.
+    std::unique_ptr<ComponentContainerBase> getNewClassInstance() const override {
+        return std::make_unique<SparseComponentContainer<T>>();
+    }
+
+   private:
+    static constexpr size_t pageSize = 4096;
+
+    // each slot holds index of component in dense vector incremented by one, or 0 if entity doesn't have component.
+    std::vector<std::unique_ptr<uint32_t[]>> pages;
+    AlignedVector<T> components;
+
+    uint32_t* findSlot(EntityID entityID) {
+        auto page = entityIndex(entityID) / pageSize;
+        if (page >= pages.size() || !pages[page]) {
+            return nullptr;
+        }
+
+        return &pages[page][entityIndex(entityID) % pageSize];
+    }
+
+    uint32_t& acquireSlot(EntityID entityID) {
+        auto page = entityIndex(entityID) / pageSize;
+        if (page >= pages.size()) {
+            pages.resize(page + 1);
+        }
+        if (!pages[page]) {
+            pages[page] = std::make_unique<uint32_t[]>(pageSize);  // value-initialized, so all slots are empty
+        }
+
+        return pages[page][entityIndex(entityID) % pageSize];
+    }
+};
+}
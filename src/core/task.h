@@ -1,5 +1,8 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
+#include "componentAccess.h"
+#include "commandBuffer.h"
 
 namespace EECS {
 class ECS;
@@ -36,6 +39,17 @@ class TaskBase {
     std::chrono::milliseconds accumulatedTime{0};
 
     ECS& ecs;
+
+    // component types read and written by update(), declared by template arguments of Task.
+    ComponentAccess access;
+
+    // structural changes recorded during update(). Applied by TaskScheduler after all due Tasks are updated.
+    CommandBuffer commands;
+
+    // tick(see ComponentManager::tick) at which previous update() started, 0 before the first one. Changes made after
+    // it have greater ticks, so update() can process only them, for ex. ecs.components.changed<Position>(lastRunTick).
+    // Changes made by this Task may be reported too, if other Tasks were updated concurrently.
+    uint64_t lastRunTick = 0;
 };
 
 /** \brief implements independient portion of code, that is executed with some frequency
@@ -52,15 +66,31 @@ class TaskBase {
 *   But Tasks are flexible, so you can use it to do any thing that should be done periodically.
 *
 *   By default, frequency will be once per game loop iteration(in config, task.defaultTaskFrequency).
+*
+*   Task can declare which component and resource types it reads and writes, by additional template arguments:
+*
+*   class PhysicsIntegrator : public Task<PhysicsIntegrator, Reads<PhysicalBodyComponent, FrameTime>,
+*                                         Writes<PositionComponent>>
+*
+*   TaskScheduler updates Tasks with non-conflicting declarations concurrently. Task without any declaration is
+*   updated alone. Components which are only read have to be accessed through const-qualified types, for ex.
+*   ecs.components.view<const PhysicalBodyComponent, PositionComponent>(), as access through non-const ones is
+*   validated as writing. Components of written types can be added and deleted directly, even if other Task does the
+*   same with other types of the same entities, as signatures of entities are updated atomically(see
+*   ComponentSignature). Creating or deleting entities isn't covered by declarations, so concurrently updated Tasks
+*   should record it in their CommandBuffer(commands member) instead.
 */
-template <typename Derived>
+template <typename Derived, typename... Access>
 class Task : public TaskBase {
    private:
-    Task(ECS& ecs) : TaskBase(ecs) { (void)taskRegistrator; }
+    Task(ECS& ecs) : TaskBase(ecs) {
+        (void)taskRegistrator;
+        access = ComponentAccess::of<Access...>();
+    }
     static TaskRegistrator<Derived> taskRegistrator;
     friend Derived;
 };
 
-template <typename Derived>
-TaskRegistrator<Derived> Task<Derived>::taskRegistrator;
+template <typename Derived, typename... Access>
+TaskRegistrator<Derived> Task<Derived, Access...>::taskRegistrator;
 }
@@ -1,10 +1,25 @@
 #include "taskScheduler.h"
+#include <atomic>
+#include <typeinfo>
+#include <limits>
 #include "utils/emath.h"
 #include "utils/timer.h"
 #include "task.h"
+#include "ecs.h"
 
 using namespace EECS;
 
+namespace {
+void runTask(TaskBase& task, size_t updates) {
+    ComponentAccess::Scope accessScope(task.access, typeid(task).name());
+    for (size_t i = 0; i < updates; i++) {
+        auto tick = task.ecs.components.advanceTick();
+        task.update();
+        task.lastRunTick = tick;
+    }
+}
+}
+
 EECS::TaskScheduler::TaskScheduler(ECS& engine) : engine(engine) { tasks.resize(TaskID::count() + 1); }
 
 EECS::TaskScheduler::~TaskScheduler() = default;
@@ -12,27 +27,107 @@ EECS::TaskScheduler::~TaskScheduler() = default;
 void EECS::TaskScheduler::clear() { tasks.clear(); }
 
 std::chrono::milliseconds EECS::TaskScheduler::update(std::chrono::milliseconds elapsedTime) {
-    std::chrono::milliseconds nextTaskUpdate{std::chrono::milliseconds::max()};
     Timer timeAlreadyElapsed;
 
+    dueTasks.clear();
+    dueUpdates.clear();
     for (auto& task : tasks) {
         if (task == nullptr) {
             continue;
         }
 
-        task->accumulatedTime = clamp(task->accumulatedTime + elapsedTime + timeAlreadyElapsed.elapsed(),
-                                      std::chrono::milliseconds(0), std::chrono::milliseconds(1000));
+        task->accumulatedTime = clamp(task->accumulatedTime + elapsedTime, std::chrono::milliseconds(0),
+                                      std::chrono::milliseconds(1000));
 
+        size_t updates = 0;
         while (task->accumulatedTime >= task->frequency) {
-            task->update();
             task->accumulatedTime -= task->frequency;
+            updates++;
+        }
+
+        if (updates > 0) {
+            dueTasks.push_back(task.get());
+            dueUpdates.push_back(updates);
+        }
+    }
+
+    // Tasks can read hierarchy concurrently, as long as it isn't rebuilt during the update
+    engine.entities.getHierarchy();
+
+    runDueTasks();
+
+    // changes made from now on are reported to every Task, including ones updated last
+    engine.components.advanceTick();
+
+    // sync point - no Task is being updated, so structural changes can be applied safely. Buffers of all due Tasks
+    // are applied together, so every container is merged at most once.
+    std::vector<CommandBuffer*> dueCommands;
+    for (auto task : dueTasks) {
+        dueCommands.push_back(&task->commands);
+    }
+    CommandBuffer::apply(dueCommands, engine.entities, engine.components);
+
+    // removals seen by every Task aren't needed anymore
+    auto oldestRunTick = std::numeric_limits<uint64_t>::max();
+    for (auto& task : tasks) {
+        if (task != nullptr) {
+            oldestRunTick = std::min(oldestRunTick, task->lastRunTick);
         }
+    }
+    if (oldestRunTick != std::numeric_limits<uint64_t>::max()) {
+        engine.components.discardChangesUntil(oldestRunTick);
+    }
 
-        if (nextTaskUpdate - timeAlreadyElapsed.elapsed() > task->frequency - task->accumulatedTime) {
-            nextTaskUpdate = task->frequency - task->accumulatedTime;
-            timeAlreadyElapsed.reset();
+    std::chrono::milliseconds nextTaskUpdate{std::chrono::milliseconds::max()};
+    for (auto& task : tasks) {
+        if (task != nullptr) {
+            nextTaskUpdate = std::min(nextTaskUpdate, task->frequency - task->accumulatedTime);
         }
     }
 
     return nextTaskUpdate - timeAlreadyElapsed.elapsed();
 }
+
+void EECS::TaskScheduler::runDueTasks() {
+    auto& pool = engine.threads;
+    if (pool.size() == 1 || dueTasks.size() <= 1) {
+        for (size_t i = 0; i < dueTasks.size(); i++) {
+            runTask(*dueTasks[i], dueUpdates[i]);
+        }
+        return;
+    }
+
+    // dependency graph: Task waits for every earlier Task it conflicts with.
+    std::vector<std::vector<size_t>> successors(dueTasks.size());
+    std::vector<std::atomic<size_t>> remainingPredecessors(dueTasks.size());
+    for (size_t i = 0; i < dueTasks.size(); i++) {
+        size_t predecessors = 0;
+        for (size_t j = 0; j < i; j++) {
+            if (dueTasks[i]->access.conflictsWith(dueTasks[j]->access)) {
+                successors[j].push_back(i);
+                predecessors++;
+            }
+        }
+        remainingPredecessors[i].store(predecessors);
+    }
+
+    TaskGroup group(pool);
+    std::function<void(size_t)> launch = [&](size_t task) {
+        group.run([&, task] {
+            runTask(*dueTasks[task], dueUpdates[task]);
+
+            for (auto successor : successors[task]) {
+                if (--remainingPredecessors[successor] == 0) {
+                    launch(successor);
+                }
+            }
+        });
+    };
+
+    for (size_t i = 0; i < dueTasks.size(); i++) {
+        if (remainingPredecessors[i].load() == 0) {
+            launch(i);
+        }
+    }
+    group.wait();
+}
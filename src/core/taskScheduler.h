@@ -13,6 +13,10 @@ class TaskBase;
 *  It is more flexible version of traditional game loop.
 *  It uses fixed timestep approach.
 *  Any Task can have different frequency - so, for example, physics can be 100Hz, rendering 30Hz, and ai 2Hz.
+*
+*  Tasks which are due in the same update and whose declared component access doesn't conflict are updated
+*  concurrently, on the engine's ThreadPool. Conflicting Tasks are updated in order of their TaskIDs, one after
+*  another. After all of them are done, CommandBuffers of updated Tasks are applied, in the same order.
 */
 class TaskScheduler {
    public:
@@ -59,5 +63,11 @@ class TaskScheduler {
    private:
     std::vector<std::unique_ptr<TaskBase>> tasks;
     ECS& engine;
+
+    // Tasks due in the current update, and how many times each of them should be updated.
+    std::vector<TaskBase*> dueTasks;
+    std::vector<size_t> dueUpdates;
+
+    void runDueTasks();
 };
 }
@@ -0,0 +1,47 @@
+#include "threadLocalSlots.h"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+using namespace EECS;
+
+namespace {
+struct Entry {
+    size_t ownerID;
+    void* object;
+    std::weak_ptr<const ThreadLocalSlots> owner;
+};
+
+std::atomic<size_t> ownerCounter{0};
+
+thread_local std::vector<Entry> threadEntries;
+// the most recently used entry, as pair of ownerID and object.
+thread_local std::pair<size_t, void*> lastEntry{SIZE_MAX, nullptr};
+}
+
+ThreadLocalSlots::ThreadLocalSlots() : ownerID(ownerCounter++), alive(this, [](const ThreadLocalSlots*) {}) {}
+
+void* ThreadLocalSlots::find() const {
+    if (lastEntry.first == ownerID) {
+        return lastEntry.second;
+    }
+
+    for (const auto& entry : threadEntries) {
+        if (entry.ownerID == ownerID) {
+            lastEntry = {entry.ownerID, entry.object};
+            return entry.object;
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadLocalSlots::add(void* object) const {
+    threadEntries.erase(std::remove_if(threadEntries.begin(), threadEntries.end(),
+                                       [](const Entry& entry) { return entry.owner.expired(); }),
+                        threadEntries.end());
+
+    threadEntries.push_back({ownerID, object, alive});
+    lastEntry = {ownerID, object};
+}
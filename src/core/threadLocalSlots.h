@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+#include <cstddef>
+
+namespace EECS {
+/** \brief finds object registered by calling thread for particular owner
+*
+* Owners used from many threads at once(CommandBuffer, SingleEventQueue) keep separate object for every thread, so
+* threads don't contend with each other. ThreadLocalSlots maps owner to object of calling thread through thread-local
+* list of entries. Lookup checks the most recently used entry first, as the same owner is usually used many times in a
+* row.
+*
+* Entries of destroyed owners are pruned from thread's list whenever the thread registers new object, so list is
+* bounded by number of live owners used by the thread, rather than by number of owners ever created. Owner ids aren't
+* reused, so entry of destroyed owner is never matched, even before it's pruned.
+*
+* Registered objects are owned by the owner, and must live as long as its ThreadLocalSlots.
+*/
+class ThreadLocalSlots {
+   public:
+    ThreadLocalSlots();
+
+    ThreadLocalSlots(const ThreadLocalSlots&) = delete;
+    ThreadLocalSlots& operator=(const ThreadLocalSlots&) = delete;
+
+    // returns object registered by calling thread, nullptr if there isn't one.
+    void* find() const;
+
+    // registers object of calling thread.
+    void add(void* object) const;
+
+   private:
+    // unique for every owner ever created.
+    const size_t ownerID;
+
+    // entries of this owner hold weak references to it, which expire when owner is destroyed.
+    std::shared_ptr<const ThreadLocalSlots> alive;
+};
+}
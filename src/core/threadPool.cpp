@@ -0,0 +1,132 @@
+#include "threadPool.h"
+
+using namespace EECS;
+
+namespace {
+// pool which owns the current thread(if any) and index of thread's queue in that pool.
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentQueueIndex = 0;
+}
+
+void TaskGroup::run(std::function<void()> job) {
+    if (pool.size() == 1) {
+        job();
+        return;
+    }
+
+    pending++;
+    pool.push({std::move(job), &pending});
+}
+
+void TaskGroup::wait() {
+    auto queueIndex = pool.ownQueueIndex();
+    while (pending.load() != 0) {
+        if (!pool.runPendingJob(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ThreadPool::ThreadPool(size_t threadCount) { setThreadCount(threadCount); }
+
+ThreadPool::~ThreadPool() { stopWorkers(); }
+
+void ThreadPool::setThreadCount(size_t threadCount) {
+    stopWorkers();
+    startWorkers(std::max<size_t>(threadCount, 1) - 1);
+}
+
+void ThreadPool::startWorkers(size_t workerCount) {
+    stopping = false;
+
+    queues.clear();
+    for (size_t i = 0; i <= workerCount; i++) {
+        queues.push_back(std::make_unique<JobQueue>());
+    }
+
+    for (size_t i = 1; i <= workerCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void ThreadPool::workerLoop(size_t queueIndex) {
+    currentPool = this;
+    currentQueueIndex = queueIndex;
+
+    while (true) {
+        if (runPendingJob(queueIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping || queuedJobs.load() != 0; });
+        if (stopping && queuedJobs.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::push(Job job) {
+    auto& queue = *queues[ownQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    {
+        // counter is modified under lock, so sleeping workers can't miss the notification
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedJobs++;
+    }
+    wakeUp.notify_one();
+}
+
+bool ThreadPool::runPendingJob(size_t queueIndex) {
+    Job job;
+    bool found = false;
+
+    // own queue is used as a stack, other queues are robbed from the opposite end
+    {
+        auto& ownQueue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(ownQueue.mutex);
+        if (!ownQueue.jobs.empty()) {
+            job = std::move(ownQueue.jobs.back());
+            ownQueue.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    for (size_t i = 1; !found && i < queues.size(); i++) {
+        auto& victim = *queues[(queueIndex + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    queuedJobs--;
+    job.function();
+    (*job.pending)--;
+
+    return true;
+}
+
+size_t ThreadPool::ownQueueIndex() const { return currentPool == this ? currentQueueIndex : 0; }
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+namespace EECS {
+class ThreadPool;
+
+/** \brief set of jobs which can be waited for together
+*
+* Jobs are executed by ThreadPool. Thread which waits for the group doesn't idle - it executes pending jobs
+* until all jobs of the group are done, so groups can be nested(job can run and wait for its own group).
+*/
+class TaskGroup {
+   public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // schedules job for execution. If pool has no worker threads, job is executed immediately.
+    void run(std::function<void()> job);
+
+    // blocks until all jobs scheduled in this group are done, executing pending jobs in the meantime.
+    void wait();
+
+   private:
+    ThreadPool& pool;
+    std::atomic<size_t> pending{0};
+};
+
+/** \brief persistent set of worker threads, shared by the whole engine
+*
+* Every worker has its own queue of jobs. Worker takes jobs from the back of its own queue(most recently scheduled,
+* so likely still in cache), and when it's empty, steals from the front of other queues. Jobs scheduled from
+* threads outside the pool go to a separate shared queue, from which workers steal as well.
+*
+* threadCount includes thread which schedules jobs and waits for them, so pool of size N spawns N - 1 workers.
+* Pool of size 1 executes all jobs on the calling thread.
+*/
+class ThreadPool {
+   public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // stops current workers(after they finish their jobs) and spawns threadCount - 1 new ones.
+    void setThreadCount(size_t threadCount);
+
+    // number of threads executing jobs, including thread which waits for them.
+    size_t size() const { return workers.size() + 1; }
+
+    /** \brief calls function(chunkBegin, chunkEnd) for consecutive chunks of [begin, end) range, in parallel
+    *
+    * Every chunk except the last one has exactly *grain* elements, so chunk index is (chunkBegin - begin) / grain.
+    * Returns after all chunks are processed.
+    */
+    template <class Function>
+    void parallelFor(size_t begin, size_t end, size_t grain, Function&& function) {
+        grain = std::max<size_t>(grain, 1);
+        if (size() == 1 || end - begin <= grain) {
+            for (auto chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+                function(chunkBegin, std::min(end, chunkBegin + grain));
+            }
+            return;
+        }
+
+        TaskGroup group(*this);
+        for (auto chunkBegin = begin + grain; chunkBegin < end; chunkBegin += grain) {
+            auto chunkEnd = std::min(end, chunkBegin + grain);
+            group.run([&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); });
+        }
+
+        function(begin, begin + grain);
+        group.wait();
+    }
+
+   private:
+    struct Job {
+        std::function<void()> function;
+        std::atomic<size_t>* pending;
+    };
+
+    struct JobQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // queues[0] is shared queue for jobs scheduled from outside of the pool, queues[i] belongs to workers[i - 1].
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<size_t> queuedJobs{0};
+    bool stopping = false;
+
+    void startWorkers(size_t workerCount);
+    void stopWorkers();
+    void workerLoop(size_t queueIndex);
+
+    void push(Job job);
+
+    // executes single pending job, preferably from given queue. Returns false if there was nothing to execute.
+    bool runPendingJob(size_t queueIndex);
+
+    // index of queue owned by the calling thread, or 0 if it's not a worker of this pool.
+    size_t ownQueueIndex() const;
+
+    friend class TaskGroup;
+};
+}
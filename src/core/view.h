@@ -0,0 +1,210 @@
+#pragma once
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <initializer_list>
+#include "entityID.h"
+#include "componentStorage.h"
+#include "componentContainerID.h"
+
+namespace EECS {
+// Filters of views. Entities having any of Excluded types are skipped, Optional types are passed by pointer, which is
+// nullptr if entity doesn't have such component. Passed to ComponentManager::view through exclude and optional
+// variables, for ex. components.view<Transform, Renderable>(exclude<Hidden>, optional<Velocity>).
+template <class... Types>
+struct Exclude {};
+
+template <class... Types>
+struct Optional {};
+
+template <class... Types>
+constexpr Exclude<Types...> exclude{};
+
+template <class... Types>
+constexpr Optional<Types...> optional{};
+
+template <class ExcludeFilter, class OptionalFilter, class Head, class... Tail>
+class BasicView;
+
+/** \brief lazy range over entities which have at least given component types
+*
+* Obtained from ComponentManager::view<Head, Tail...>(). Nothing is materialized - iteration walks container of Head
+* components and looks up remaining types for each of them, skipping entities which lack any of them.
+*
+* Usage:
+* for (auto entry : components.view<Position, Velocity>()) {
+*     std::get<1>(entry).x += std::get<2>(entry).dx; // entry is std::tuple<EntityID, Position&, Velocity&>
+* }
+*
+* or, without tuple:
+* components.view<Position, Velocity>().each([](EntityID entity, Position& position, Velocity& velocity) { ... });
+*
+* View can also skip entities which have any of Excluded types, and pass Optional types by pointer, after required ones:
+* components.view<Transform, Renderable>(exclude<Hidden>, optional<Velocity>).each(
+*     [](EntityID entity, Transform& transform, Renderable& renderable, Velocity* velocity) { ... });
+*
+* If signatures of entities are available(ComponentManager is linked with EntityManager), required and excluded types
+* are checked with single bitset test per entity, and missing optional components aren't looked up at all. Otherwise
+* filters are evaluated by lookups, during the same pass.
+*
+* View is invalidated by adding or deleting components of any of its types.
+*/
+template <class... Excluded, class... Optionals, class Head, class... Tail>
+class BasicView<Exclude<Excluded...>, Optional<Optionals...>, Head, Tail...> {
+    using Found = std::tuple<Tail*..., Optionals*...>;
+    using TailIndices = std::index_sequence_for<Tail...>;
+    using ExcludedIndices = std::index_sequence_for<Excluded...>;
+    using OptionalIndices = std::index_sequence_for<Optionals...>;
+
+   public:
+    using value_type = std::tuple<EntityID, Head&, Tail&..., Optionals*...>;
+
+    class Iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename BasicView::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        Iterator(BasicView& view, size_t index) : view(&view), index(index) { skipNonMatching(); }
+
+        value_type operator*() const { return dereference(TailIndices{}, OptionalIndices{}); }
+
+        Iterator& operator++() {
+            index++;
+            skipNonMatching();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+       private:
+        BasicView* view;
+        size_t index;
+        Found found;
+
+        void skipNonMatching() {
+            auto& heads = view->headContainer->getAllComponents();
+            while (index < heads.size() && !view->find(heads[index].entityID, found)) {
+                index++;
+            }
+        }
+
+        template <size_t... TailIndex, size_t... OptionalIndex>
+        value_type dereference(std::index_sequence<TailIndex...>, std::index_sequence<OptionalIndex...>) const {
+            auto& head = view->headContainer->getAllComponents()[index];
+            return value_type{head.entityID, head, *std::get<TailIndex>(found)...,
+                              std::get<sizeof...(Tail) + OptionalIndex>(found)...};
+        }
+    };
+
+    // signatures of entities are used to evaluate filters, if they aren't nullptr.
+    BasicView(const std::vector<ComponentSignature>* signatures, ContainerFor<Head>* headContainer,
+              ContainerFor<Tail>*... tailContainers, ContainerFor<Excluded>*... excludedContainers,
+              ContainerFor<Optionals>*... optionalContainers)
+        : signatures(signatures),
+          headContainer(headContainer),
+          tailContainers(tailContainers...),
+          excludedContainers(excludedContainers...),
+          optionalContainers(optionalContainers...) {}
+
+    Iterator begin() { return Iterator(*this, 0); }
+    Iterator end() { return Iterator(*this, headContainer->getAllComponents().size()); }
+
+    // calls function(EntityID, Head&, Tail&..., Optionals*...) for every entity in the view.
+    template <class Function>
+    void each(Function&& function) {
+        Found found;
+        for (auto& head : headContainer->getAllComponents()) {
+            if (find(head.entityID, found)) {
+                invoke(function, head, found, TailIndices{}, OptionalIndices{});
+            }
+        }
+    }
+
+   private:
+    const std::vector<ComponentSignature>* signatures;
+    ContainerFor<Head>* headContainer;
+    std::tuple<ContainerFor<Tail>*...> tailContainers;
+    std::tuple<ContainerFor<Excluded>*...> excludedContainers;
+    std::tuple<ContainerFor<Optionals>*...> optionalContainers;
+
+    // fills found with components owned by given entity. Returns false if entity doesn't pass the filters.
+    bool find(EntityID entityID, Found& found) {
+        const ComponentSignature* signature = nullptr;
+        if (signatures && entityIndex(entityID) < signatures->size()) {
+            static const auto required = ComponentContainerID::signature<Tail...>();
+            static const auto excluded = ComponentContainerID::signature<Excluded...>();
+
+            signature = &(*signatures)[entityIndex(entityID)];
+            if (!signature->containsAll(required) || signature->containsAny(excluded)) {
+                return false;
+            }
+        } else if (anyExcluded(entityID, ExcludedIndices{})) {
+            return false;
+        }
+
+        if (!findTail(entityID, found, TailIndices{})) {
+            return false;
+        }
+
+        findOptional(entityID, signature, found, OptionalIndices{});
+        return true;
+    }
+
+    // Returns false on first missing component.
+    template <size_t... Indices>
+    bool findTail(EntityID entityID, Found& found, std::index_sequence<Indices...>) {
+        (void)entityID;  // unused by single-type views
+        bool all = true;
+        (void)std::initializer_list<int>{
+            (all = all && (std::get<Indices>(found) = std::get<Indices>(tailContainers)->getComponent(entityID)) !=
+                              nullptr,
+             0)...};
+        return all;
+    }
+
+    template <size_t... Indices>
+    bool anyExcluded(EntityID entityID, std::index_sequence<Indices...>) {
+        (void)entityID;
+        bool any = false;
+        (void)std::initializer_list<int>{
+            (any = any || std::get<Indices>(excludedContainers)->getComponent(entityID) != nullptr, 0)...};
+        return any;
+    }
+
+    // components which aren't in signature(if it's given) aren't looked up.
+    template <size_t... Indices>
+    void findOptional(EntityID entityID, const ComponentSignature* signature, Found& found,
+                      std::index_sequence<Indices...>) {
+        (void)entityID;
+        (void)signature;
+        (void)std::initializer_list<int>{
+            (std::get<sizeof...(Tail) + Indices>(found) =
+                 !signature || signature->test(ComponentContainerID::get<Optionals>())
+                     ? std::get<Indices>(optionalContainers)->getComponent(entityID)
+                     : nullptr,
+             0)...};
+    }
+
+    template <class Function, size_t... TailIndex, size_t... OptionalIndex>
+    void invoke(Function& function, Head& head, Found& found, std::index_sequence<TailIndex...>,
+                std::index_sequence<OptionalIndex...>) {
+        function(head.entityID, head, *std::get<TailIndex>(found)...,
+                 std::get<sizeof...(Tail) + OptionalIndex>(found)...);
+    }
+};
+
+// view over entities which have at least given component types, without filters.
+template <class Head, class... Tail>
+using View = BasicView<Exclude<>, Optional<>, Head, Tail...>;
+}
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <thread>
+#include "include/ecs/ecs.h"
+#include "utils/timer.h"
+using namespace EECS;
+
+// Benchmarks are hidden from the default run, use `tests [benchmark]` to execute them.
+
+struct BenchPosition : public Component<BenchPosition> {
+    float x = 0, y = 0;
+};
+
+struct BenchVelocity : public Component<BenchVelocity> {
+    float dx = 1, dy = 1;
+};
+
+TEST_CASE("Intersection scaling with thread count", "[.][benchmark]") {
+    const size_t entityCount = 500000;
+    const size_t repetitions = 20;
+
+    ComponentManager comps;
+    for (EntityID entity = 1; entity <= entityCount; entity++) {
+        comps.addComponent<BenchPosition>(entity);
+        if (entity % 2 == 0) {
+            comps.addComponent<BenchVelocity>(entity);
+        }
+    }
+
+    auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    printf("intersection<Position, Velocity>() over %zu entities, %u hardware threads\n", entityCount, maxThreads);
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        comps.setThreadPool(pool);
+
+        Timer timer;
+        size_t matched = 0;
+        for (size_t i = 0; i < repetitions; i++) {
+            matched += comps.intersection<BenchPosition, BenchVelocity>().size();
+        }
+        auto elapsed = timer.elapsed();
+
+        REQUIRE(matched == repetitions * entityCount / 2);
+        printf("  %2zu threads: %6.2f ms per call\n", threads, (double)elapsed.count() / repetitions);
+    }
+}
+
+struct BenchRareTag : public Component<BenchRareTag> {};
+
+TEST_CASE("Intersection with rare component", "[.][benchmark]") {
+    const size_t entityCount = 500000;
+    const size_t repetitions = 1000;
+
+    ComponentManager comps;
+    for (EntityID entity = 1; entity <= entityCount; entity++) {
+        comps.addComponent<BenchPosition>(entity);
+        if (entity % 1000 == 0) {
+            comps.addComponent<BenchRareTag>(entity);
+        }
+    }
+
+    Timer timer;
+    size_t matched = 0;
+    for (size_t i = 0; i < repetitions; i++) {
+        matched += comps.intersection<BenchPosition, BenchRareTag>().size();
+    }
+    auto elapsed = timer.elapsed();
+
+    REQUIRE(matched == repetitions * entityCount / 1000);
+    printf("intersection<Position, RareTag>() over %zu entities: %6.3f ms per call\n", entityCount,
+           (double)elapsed.count() / repetitions);
+}
@@ -1,4 +1,8 @@
 #include <catch.hpp>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "ecs/ecs.h"
 using namespace EECS;
 
@@ -130,3 +134,225 @@ TEST_CASE("Task retrieval and delete test") {
     taskManager.deleteTask<TestTask>();
     REQUIRE(!taskManager.getTask<TestTask>());
 }
+
+struct SchedulerPosition : Component<SchedulerPosition> {
+    int x = 0;
+};
+
+struct SchedulerVelocity : Component<SchedulerVelocity> {
+    int dx = 0;
+};
+
+struct SchedulerHidden : Component<SchedulerHidden> {};
+
+// counts Tasks which are updated at the same time
+static std::atomic<int> concurrentlyUpdated{0};
+static std::atomic<int> maxConcurrentlyUpdated{0};
+
+// barrier at which Tasks expected to be updated concurrently wait for each other, so they overlap regardless of how
+// busy the machine is. Waiting is bounded, so if Tasks aren't updated concurrently, the test fails instead of hanging.
+class Rendezvous {
+   public:
+    // makes given number of Tasks wait for each other. 0 disables waiting.
+    void reset(size_t participants) {
+        std::lock_guard<std::mutex> lock(mutex);
+        expected = participants;
+        arrived = 0;
+    }
+
+    void arrive() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (expected == 0) {
+            return;
+        }
+
+        auto currentRound = round;
+        if (++arrived == expected) {
+            arrived = 0;
+            round++;
+            allArrived.notify_all();
+            return;
+        }
+
+        allArrived.wait_for(lock, std::chrono::seconds(10), [&] { return round != currentRound; });
+    }
+
+   private:
+    std::mutex mutex;
+    std::condition_variable allArrived;
+    size_t expected = 0;
+    size_t arrived = 0;
+    size_t round = 0;
+};
+
+static Rendezvous rendezvous;
+
+// updates counter, recording how many Tasks are being updated at the same time
+void measuredUpdate(size_t& updateCounter) {
+    ++concurrentlyUpdated;
+    rendezvous.arrive();
+
+    auto current = concurrentlyUpdated.load();
+    auto previousMax = maxConcurrentlyUpdated.load();
+    while (current > previousMax && !maxConcurrentlyUpdated.compare_exchange_weak(previousMax, current)) {
+    }
+
+    // gives conflicting Tasks a chance to overlap, if they were wrongly updated concurrently
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    updateCounter++;
+    concurrentlyUpdated--;
+}
+
+class PositionWriter : public Task<PositionWriter, Writes<SchedulerPosition>> {
+   public:
+    PositionWriter(ECS& engine) : Task(engine) {}
+
+    void update() override { measuredUpdate(updateCounter); }
+
+    size_t updateCounter = 0;
+};
+
+class PositionReader : public Task<PositionReader, Reads<SchedulerPosition>> {
+   public:
+    PositionReader(ECS& engine) : Task(engine) {}
+
+    void update() override { measuredUpdate(updateCounter); }
+
+    size_t updateCounter = 0;
+};
+
+class VelocityWriter : public Task<VelocityWriter, Reads<SchedulerPosition>, Writes<SchedulerVelocity>> {
+   public:
+    VelocityWriter(ECS& engine) : Task(engine) {}
+
+    void update() override { measuredUpdate(updateCounter); }
+
+    size_t updateCounter = 0;
+};
+
+class UndeclaredAccessTask : public Task<UndeclaredAccessTask, Reads<SchedulerPosition>> {
+   public:
+    UndeclaredAccessTask(ECS& engine) : Task(engine) {}
+
+    void update() override {
+        ecs.components.getComponent<const SchedulerPosition>(1);
+        ecs.components.addComponent<SchedulerVelocity>(1);
+    }
+};
+
+class MutableAccessTask : public Task<MutableAccessTask, Reads<SchedulerPosition>> {
+   public:
+    MutableAccessTask(ECS& engine) : Task(engine) {}
+
+    void update() override {
+        for (auto position : ecs.components.view<const SchedulerPosition>()) {
+            (void)std::get<1>(position).x;
+        }
+        ecs.components.getComponent<SchedulerPosition>(1)->x++;
+    }
+};
+
+class ExcludingTask : public Task<ExcludingTask, Reads<SchedulerHidden>, Writes<SchedulerPosition>> {
+   public:
+    ExcludingTask(ECS& engine) : Task(engine) {}
+
+    void update() override {
+        for (auto position : ecs.components.view<SchedulerPosition>(exclude<SchedulerHidden>)) {
+            std::get<1>(position).x++;
+        }
+    }
+};
+
+TEST_CASE("Component access declarations conflicts", "[TaskScheduler]") {
+    auto positionReader = ComponentAccess::of<Reads<SchedulerPosition>>();
+    auto positionWriter = ComponentAccess::of<Writes<SchedulerPosition>>();
+    auto velocityWriter = ComponentAccess::of<Reads<SchedulerPosition>, Writes<SchedulerVelocity>>();
+    auto undeclared = ComponentAccess::of<>();
+
+    // readers never conflict with each other
+    REQUIRE_FALSE(positionReader.conflictsWith(positionReader));
+    REQUIRE_FALSE(positionReader.conflictsWith(velocityWriter));
+
+    // writer conflicts with anyone accessing the same type
+    REQUIRE(positionWriter.conflictsWith(positionReader));
+    REQUIRE(positionWriter.conflictsWith(positionWriter));
+    REQUIRE(positionWriter.conflictsWith(velocityWriter));
+    REQUIRE(velocityWriter.conflictsWith(velocityWriter));
+
+    // Task without declaration conflicts with everything
+    REQUIRE(undeclared.conflictsWith(positionReader));
+
+    REQUIRE(velocityWriter.canRead(ComponentContainerID::get<SchedulerVelocity>()));
+    REQUIRE_FALSE(positionReader.canWrite(ComponentContainerID::get<SchedulerPosition>()));
+}
+
+TEST_CASE("Non-conflicting tasks are updated concurrently, conflicting ones are not", "[TaskScheduler]") {
+    ECS engine;
+    engine.threads.setThreadCount(4);
+    TaskScheduler taskManager(engine);
+
+    auto positionWriter = taskManager.addTask<PositionWriter>();
+    auto positionReader = taskManager.addTask<PositionReader>();
+    positionWriter->frequency = positionReader->frequency = std::chrono::milliseconds(1);
+
+    maxConcurrentlyUpdated = 0;
+    taskManager.update(std::chrono::milliseconds(3));
+    REQUIRE(positionWriter->updateCounter == 3);
+    REQUIRE(positionReader->updateCounter == 3);
+    REQUIRE(maxConcurrentlyUpdated == 1);
+
+    // velocity writer only reads position, so it can be updated alongside position reader
+    taskManager.deleteTask<PositionWriter>();
+    auto velocityWriter = taskManager.addTask<VelocityWriter>();
+    velocityWriter->frequency = std::chrono::milliseconds(1);
+
+    maxConcurrentlyUpdated = 0;
+    rendezvous.reset(2);
+    taskManager.update(std::chrono::milliseconds(3));
+    rendezvous.reset(0);
+    REQUIRE(positionReader->updateCounter == 6);
+    REQUIRE(velocityWriter->updateCounter == 3);
+    REQUIRE(maxConcurrentlyUpdated == 2);
+}
+
+#ifndef NDEBUG
+TEST_CASE("Undeclared component access is reported in debug builds", "[TaskScheduler]") {
+    ECS engine;
+    engine.components.addComponent<SchedulerPosition>(engine.entities.addEntity());
+    auto task = engine.tasks.addTask<UndeclaredAccessTask>();
+    task->frequency = std::chrono::milliseconds(1);
+
+    auto violationsBefore = ComponentAccess::violationCount();
+    engine.tasks.update(std::chrono::milliseconds(1));
+
+    // reading declared type is fine, adding undeclared one is not
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore + 1);
+
+    // access outside of Task update isn't validated
+    engine.components.addComponent<SchedulerVelocity>(1);
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore + 1);
+
+    // access through non-const type is validated as write, even if nothing is added or deleted
+    engine.tasks.deleteTask<UndeclaredAccessTask>();
+    engine.tasks.addTask<MutableAccessTask>()->frequency = std::chrono::milliseconds(1);
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore + 2);
+    REQUIRE(engine.components.getComponent<SchedulerPosition>(1)->x == 1);
+}
+
+TEST_CASE("Excluded component types are validated as read", "[TaskScheduler]") {
+    ECS engine;
+    auto visible = engine.entities.addEntity();
+    auto hidden = engine.entities.addEntity();
+    engine.components.addComponent<SchedulerPosition>(visible);
+    engine.components.addComponent<SchedulerPosition>(hidden);
+    engine.components.addComponent<SchedulerHidden>(hidden);
+    engine.tasks.addTask<ExcludingTask>()->frequency = std::chrono::milliseconds(1);
+
+    auto violationsBefore = ComponentAccess::violationCount();
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore);
+    REQUIRE(engine.components.getComponent<SchedulerPosition>(visible)->x == 1);
+    REQUIRE(engine.components.getComponent<SchedulerPosition>(hidden)->x == 0);
+}
+#endif
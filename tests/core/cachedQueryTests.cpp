@@ -0,0 +1,180 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct QueryPosition : public Component<QueryPosition> {
+    QueryPosition(int x = 0) : x(x) {}
+
+    int x = 0;
+};
+
+struct QueryVelocity : public Component<QueryVelocity> {
+    using Storage = SparseStorage;
+
+    QueryVelocity(int dx = 0) : dx(dx) {}
+
+    int dx = 0;
+};
+
+// checks if query returns the same entities as intersection. Intersection may be driven by sparse container, so its
+// order is unspecified.
+static bool sameAsIntersection(ComponentManager& components) {
+    std::vector<EntityID> expected;
+    for (auto& entry : components.intersection<QueryPosition, QueryVelocity>()) {
+        expected.push_back(entry.entity());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    return components.cachedQuery<QueryPosition, QueryVelocity>().entities() == expected;
+}
+
+TEST_CASE("Cached query follows structural changes") {
+    ECS engine;
+    auto& components = engine.components;
+
+    auto entities = engine.entities.createEntities(100);
+    for (size_t i = 0; i < entities.size(); i++) {
+        components.addComponent<QueryPosition>(entities[i], (int)i);
+        if (i % 2 == 0) {
+            components.addComponent<QueryVelocity>(entities[i], 1);
+        }
+    }
+
+    auto& query = components.cachedQuery<QueryPosition, QueryVelocity>();
+    REQUIRE((&query == &components.cachedQuery<QueryPosition, QueryVelocity>()));
+    REQUIRE(query.size() == 50);
+
+    query.each([](EntityID, QueryPosition& position, QueryVelocity& velocity) { position.x += velocity.dx; });
+    REQUIRE(components.getComponent<QueryPosition>(entities[0])->x == 1);
+    REQUIRE(components.getComponent<QueryPosition>(entities[1])->x == 1);
+
+    components.addComponent<QueryVelocity>(entities[1]);
+    components.deleteComponent<QueryPosition>(entities[2]);
+    components.deleteComponent<QueryVelocity>(entities[4]);
+    REQUIRE(query.size() == 49);
+    REQUIRE(sameAsIntersection(components));
+
+    std::vector<EntityID> odd;
+    for (size_t i = 1; i < entities.size(); i += 2) {
+        odd.push_back(entities[i]);
+    }
+    components.addComponents<QueryVelocity>(odd);
+    REQUIRE(query.size() == 98);
+    REQUIRE(sameAsIntersection(components));
+
+    engine.entities.deleteEntity(entities[10]);
+    engine.entities.destroyEntities({entities[11], entities[12]});
+    REQUIRE(query.size() == 95);
+
+    auto clone = engine.entities.cloneEntity(entities[20]);
+    REQUIRE(query.size() == 96);
+    REQUIRE(query.entities().back() == clone.getID());
+    REQUIRE(sameAsIntersection(components));
+
+    CommandBuffer commands;
+    auto created = commands.createEntity();
+    commands.addComponent<QueryPosition>(created);
+    commands.addComponent<QueryVelocity>(created);
+    commands.deleteComponent<QueryVelocity>(entities[30]);
+    commands.apply(engine.entities, components);
+    REQUIRE(query.size() == 96);
+    REQUIRE(sameAsIntersection(components));
+
+    components.clear<QueryVelocity>();
+    REQUIRE(query.size() == 0);
+    components.addComponent<QueryVelocity>(entities[50]);
+    REQUIRE(query.size() == 1);
+
+    engine.entities.clear();
+    REQUIRE(query.size() == 0);
+}
+
+TEST_CASE("Cached query without EntityManager") {
+    ComponentManager components;
+    for (EntityID i = 1; i <= 10; i++) {
+        components.addComponent<QueryPosition>(i);
+    }
+    components.addComponent<QueryVelocity>(3);
+
+    auto& query = components.cachedQuery<QueryVelocity, QueryPosition>();
+    REQUIRE((query.entities() == std::vector<EntityID>{3}));
+
+    components.addComponent<QueryVelocity>(11);
+    components.addComponent<QueryPosition>(11);
+    components.addComponent<QueryVelocity>(1);
+    REQUIRE((query.entities() == std::vector<EntityID>{1, 3, 11}));
+
+    components.deleteComponent<QueryPosition>(3);
+    REQUIRE((query.entities() == std::vector<EntityID>{1, 11}));
+}
+
+TEST_CASE("Cached query statistics") {
+    ComponentManager components;
+    components.addComponent<QueryPosition>(1);
+    components.addComponent<QueryVelocity>(1);
+
+    auto& query = components.cachedQuery<QueryPosition, QueryVelocity>();
+    REQUIRE(query.statistics().hitRate() == 0.0);
+
+    for (auto i = 0; i < 3; i++) {
+        REQUIRE(query.size() == 1);
+    }
+
+    auto statistics = query.statistics();
+    REQUIRE(statistics.misses == 1);
+    REQUIRE(statistics.hits == 2);
+    REQUIRE(statistics.updates == 0);
+
+    components.addComponent<QueryPosition>(2);
+    components.addComponent<QueryVelocity>(2);
+    REQUIRE(query.size() == 2);
+    REQUIRE(query.statistics().updates == 2);
+
+    // clearing drops results, which are rebuilt on next access
+    components.clear<QueryPosition>();
+    REQUIRE(query.size() == 0);
+    statistics = query.statistics();
+    REQUIRE(statistics.misses == 2);
+    REQUIRE(statistics.hits == 3);
+    REQUIRE(statistics.hitRate() == 0.6);
+}
+
+TEST_CASE("Cached query refreshes cached components after they move") {
+    ECS engine;
+    auto& components = engine.components;
+
+    auto entities = engine.entities.createEntities(20);
+    for (size_t i = 0; i < entities.size(); i++) {
+        components.addComponent<QueryPosition>(entities[i], (int)i);
+        if (i >= 10) {
+            components.addComponent<QueryVelocity>(entities[i], (int)i);
+        }
+    }
+
+    auto& query = components.cachedQuery<QueryPosition, QueryVelocity>();
+    auto check = [&query](size_t expectedSize) {
+        size_t visited = 0;
+        query.each([&visited](EntityID entity, QueryPosition& position, QueryVelocity& velocity) {
+            REQUIRE(position.entityID == entity);
+            REQUIRE(velocity.entityID == entity);
+            REQUIRE(position.x == velocity.dx);
+            visited++;
+        });
+        REQUIRE(visited == expectedSize);
+    };
+    check(10);
+
+    // deleting position of entity outside of the query shifts positions of matching ones
+    components.deleteComponent<QueryPosition>(entities[0]);
+    check(10);
+
+    // sparse container moves its last component into the hole
+    components.deleteComponent<QueryVelocity>(entities[10]);
+    check(9);
+
+    engine.entities.destroyEntities({entities[1], entities[11]});
+    check(8);
+
+    components.addComponent<QueryVelocity>(entities[2], 2);
+    check(9);
+}
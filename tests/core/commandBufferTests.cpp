@@ -0,0 +1,179 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct CommandedComponent : public Component<CommandedComponent> {
+    explicit CommandedComponent(int value = 0) : value(value) {}
+
+    int value = 0;
+};
+
+struct CommandedSparseComponent : public Component<CommandedSparseComponent> {
+    using Storage = SparseStorage;
+
+    explicit CommandedSparseComponent(int value = 0) : value(value) {}
+
+    int value = 0;
+};
+
+class SpawningTask : public Task<SpawningTask, Reads<CommandedComponent>> {
+   public:
+    SpawningTask(ECS& engine) : Task(engine) {}
+
+    void update() override {
+        // adding components while iterating would invalidate the view, so it's deferred
+        for (auto entry : ecs.components.view<const CommandedComponent>()) {
+            auto spawned = commands.createEntity();
+            commands.addComponent<CommandedSparseComponent>(spawned, std::get<1>(entry).value);
+            commands.destroyEntity(std::get<0>(entry));
+        }
+    }
+};
+
+TEST_CASE("Command buffer applies recorded changes at once") {
+    ECS engine;
+    CommandBuffer commands;
+
+    auto existing = engine.entities.addEntity().getID();
+    auto doomed = engine.entities.addEntity().getID();
+    engine.components.addComponent<CommandedComponent>(doomed, 1);
+
+    auto created = commands.createEntity();
+    REQUIRE(isDeferredEntity(created));
+    commands.addComponent<CommandedComponent>(created, 10);
+    commands.addComponent<CommandedSparseComponent>(created, 11);
+    commands.addComponent<CommandedComponent>(existing, 20);
+    commands.deleteComponent<CommandedComponent>(doomed);
+    commands.destroyEntity(doomed);
+
+    // nothing happens until the buffer is applied
+    REQUIRE_FALSE(commands.empty());
+    REQUIRE(engine.entities.size() == 2);
+    REQUIRE(engine.components.getComponent<CommandedComponent>(existing) == nullptr);
+
+    commands.apply(engine.entities, engine.components);
+    REQUIRE(commands.empty());
+
+    REQUIRE(engine.entities.size() == 2);
+    REQUIRE_FALSE(engine.entities.entityExists(doomed));
+    REQUIRE(engine.components.getComponent<CommandedComponent>(existing)->value == 20);
+
+    auto createdComponent = engine.components.getAllComponents<CommandedSparseComponent>().at(0);
+    REQUIRE(createdComponent.value == 11);
+    REQUIRE(engine.entities.entityExists(createdComponent.entityID));
+    REQUIRE(engine.components.getComponent<CommandedComponent>(createdComponent.entityID)->value == 10);
+}
+
+TEST_CASE("Command buffer sets parents of created entities") {
+    ECS engine;
+    CommandBuffer commands;
+
+    auto parent = engine.entities.addEntity().getID();
+    auto child = commands.createEntity();
+    auto grandchild = commands.createEntity();
+    commands.setParent(child, parent);
+    commands.setParent(grandchild, child);
+    commands.apply(engine.entities, engine.components);
+
+    auto children = engine.entities.getChildren(parent);
+    REQUIRE(children.size() == 1);
+    REQUIRE(engine.entities.getChildren(children[0]).size() == 1);
+
+    // destruction is applied after parents are set, and cascades
+    commands.setParent(engine.entities.addEntity(), children[0]);
+    commands.destroyEntity(children[0]);
+    commands.apply(engine.entities, engine.components);
+    REQUIRE(engine.entities.size() == 1);
+}
+
+TEST_CASE("Command buffer: only the last command for component of entity matters") {
+    ECS engine;
+    CommandBuffer commands;
+
+    auto first = engine.entities.addEntity().getID();
+    auto second = engine.entities.addEntity().getID();
+    engine.components.addComponent<CommandedComponent>(second, 1);
+
+    commands.addComponent<CommandedComponent>(first, 1);
+    commands.deleteComponent<CommandedComponent>(first);
+    commands.addComponent<CommandedComponent>(first, 2);
+
+    commands.deleteComponent<CommandedComponent>(second);
+    commands.addComponent<CommandedComponent>(second, 3);
+    commands.deleteComponent<CommandedComponent>(second);
+
+    // commands concerning non-existent entities are skipped
+    commands.addComponent<CommandedComponent>(12345, 4);
+
+    commands.apply(engine.entities, engine.components);
+
+    REQUIRE(engine.components.getComponent<CommandedComponent>(first)->value == 2);
+    REQUIRE(engine.components.getComponent<CommandedComponent>(second) == nullptr);
+    REQUIRE(engine.components.getAllComponents<CommandedComponent>().size() == 1);
+}
+
+TEST_CASE("Command buffer can be recorded from many threads") {
+    ECS engine;
+    ThreadPool pool(4);
+    CommandBuffer commands;
+
+    auto entities = engine.entities.createEntities(1000);
+    pool.parallelFor(0, entities.size(), 10, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            commands.addComponent<CommandedComponent>(entities[i], (int)i);
+        }
+    });
+
+    commands.apply(engine.entities, engine.components);
+
+    REQUIRE(engine.components.getAllComponents<CommandedComponent>().size() == 1000);
+    REQUIRE(engine.components.getComponent<CommandedComponent>(entities[999])->value == 999);
+}
+
+TEST_CASE("Several command buffers are applied in one pass, in given order") {
+    ECS engine;
+    CommandBuffer first, second;
+
+    auto existing = engine.entities.addEntity().getID();
+
+    // temporary ids of both buffers are the same, but refer to different entities
+    auto firstCreated = first.createEntity();
+    auto secondCreated = second.createEntity();
+    REQUIRE(firstCreated == secondCreated);
+    first.addComponent<CommandedComponent>(firstCreated, 1);
+    second.addComponent<CommandedComponent>(secondCreated, 2);
+    second.setParent(secondCreated, existing);
+
+    first.addComponent<CommandedComponent>(existing, 3);
+    second.addComponent<CommandedComponent>(existing, 4);
+
+    CommandBuffer::apply({&first, &second}, engine.entities, engine.components);
+    REQUIRE(first.empty());
+    REQUIRE(second.empty());
+
+    REQUIRE(engine.entities.size() == 3);
+    REQUIRE(engine.components.getComponent<CommandedComponent>(existing)->value == 4);
+
+    int sum = 0;
+    for (auto& component : engine.components.getAllComponents<CommandedComponent>()) {
+        sum += component.value;
+    }
+    REQUIRE(sum == 7);
+    REQUIRE(engine.entities.getChildren(existing).size() == 1);
+}
+
+TEST_CASE("Task commands are applied by TaskScheduler after update") {
+    ECS engine;
+    auto task = engine.tasks.addTask<SpawningTask>();
+    task->frequency = std::chrono::milliseconds(1);
+
+    for (auto i = 0; i < 3; i++) {
+        engine.components.addComponent<CommandedComponent>(engine.entities.addEntity(), i);
+    }
+
+    engine.tasks.update(std::chrono::milliseconds(1));
+
+    REQUIRE(engine.entities.size() == 3);
+    REQUIRE(engine.components.getAllComponents<CommandedComponent>().empty());
+    REQUIRE(engine.components.getAllComponents<CommandedSparseComponent>().size() == 3);
+}
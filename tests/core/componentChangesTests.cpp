@@ -0,0 +1,133 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct TrackedComponent : public Component<TrackedComponent> {
+    static constexpr bool trackChanges = true;
+
+    TrackedComponent(int value = 0) : value(value) {}
+
+    int value = 0;
+};
+
+TEST_CASE("Changes of components are stamped with ticks") {
+    ECS engine;
+    auto& components = engine.components;
+    auto first = engine.entities.addEntity();
+    auto second = engine.entities.addEntity();
+
+    // changes are reported if they are stamped with later tick than given one
+    auto start = components.tick();
+    components.advanceTick();
+    components.addComponent<TrackedComponent>(first);
+    REQUIRE((components.added<TrackedComponent>(start) == std::vector<EntityID>{first}));
+    REQUIRE((components.changed<TrackedComponent>(start) == std::vector<EntityID>{first}));
+
+    auto afterAdd = components.tick();
+    components.advanceTick();
+    REQUIRE(components.added<TrackedComponent>(afterAdd).empty());
+    REQUIRE(components.changed<TrackedComponent>(afterAdd).empty());
+
+    // replacing and modifying counts as change, not as addition
+    components.addComponent<TrackedComponent>(first, 5);
+    components.addComponent<TrackedComponent>(second);
+    components.modifyComponent<TrackedComponent>(second)->value = 7;
+    REQUIRE((components.added<TrackedComponent>(afterAdd) == std::vector<EntityID>{second}));
+    REQUIRE((components.changed<TrackedComponent>(afterAdd) == std::vector<EntityID>{first, second}));
+
+    auto beforeRemoval = components.tick();
+    components.advanceTick();
+    components.markChanged<TrackedComponent>(first);
+    REQUIRE((components.changed<TrackedComponent>(beforeRemoval) == std::vector<EntityID>{first}));
+
+    components.deleteComponent<TrackedComponent>(first);
+    engine.entities.deleteEntity(second);
+    REQUIRE(components.changed<TrackedComponent>(beforeRemoval).empty());
+    REQUIRE((components.removed<TrackedComponent>(beforeRemoval) == std::vector<EntityID>{first, second}));
+    REQUIRE((components.removed<TrackedComponent>(start).size() == 2));
+
+    components.discardChangesUntil(components.tick());
+    REQUIRE(components.removed<TrackedComponent>(start).empty());
+}
+
+TEST_CASE("Cloning, batches and command buffers are tracked") {
+    ECS engine;
+    auto& components = engine.components;
+    auto entities = engine.entities.createEntities(3);
+
+    auto start = components.tick();
+    components.advanceTick();
+    components.addComponents<TrackedComponent>(entities, 1);
+    auto clone = engine.entities.cloneEntity(entities[0]);
+    REQUIRE((components.added<TrackedComponent>(start).size() == 4));
+
+    auto beforeCommands = components.tick();
+    components.advanceTick();
+    CommandBuffer commands;
+    commands.addComponent<TrackedComponent>(commands.createEntity());
+    commands.deleteComponent<TrackedComponent>(clone);
+    commands.apply(engine.entities, components);
+    REQUIRE((components.added<TrackedComponent>(beforeCommands).size() == 1));
+    REQUIRE((components.removed<TrackedComponent>(beforeCommands) == std::vector<EntityID>{clone}));
+
+    auto beforeClear = components.tick();
+    components.advanceTick();
+    components.clear<TrackedComponent>();
+    REQUIRE((components.removed<TrackedComponent>(beforeClear).size() == 4));
+}
+
+class ChangeCountingTask : public Task<ChangeCountingTask, Reads<TrackedComponent>> {
+   public:
+    ChangeCountingTask(ECS& engine) : Task(engine) {}
+
+    void update() { changedCount = ecs.components.changed<TrackedComponent>(lastRunTick).size(); }
+
+    size_t changedCount = 0;
+};
+
+TEST_CASE("Task sees changes made since its last update") {
+    ECS engine;
+    auto task = engine.tasks.addTask<ChangeCountingTask>();
+    task->frequency = std::chrono::milliseconds(1);
+
+    auto entities = engine.entities.createEntities(10);
+    for (auto entity : entities) {
+        engine.components.addComponent<TrackedComponent>(entity);
+    }
+
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(task->changedCount == 10);
+
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(task->changedCount == 0);
+
+    engine.components.markChanged<TrackedComponent>(entities[3]);
+    engine.components.markChanged<TrackedComponent>(entities[4]);
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(task->changedCount == 2);
+}
+
+class ChangeMarkingTask : public Task<ChangeMarkingTask, Reads<TrackedComponent>> {
+   public:
+    ChangeMarkingTask(ECS& engine) : Task(engine) {}
+
+    void update() {
+        // reading changes is allowed, but marking them is writing
+        ecs.components.changed<TrackedComponent>(lastRunTick);
+        auto entity = ecs.components.getAllComponents<const TrackedComponent>()[0].entityID;
+        ecs.components.markChanged<TrackedComponent>(entity);
+    }
+};
+
+TEST_CASE("Marking changes is validated as writing") {
+    ECS engine;
+    engine.components.addComponent<TrackedComponent>(engine.entities.addEntity());
+    engine.tasks.addTask<ChangeMarkingTask>()->frequency = std::chrono::milliseconds(1);
+
+    auto violationsBefore = ComponentAccess::violationCount();
+    engine.tasks.update(std::chrono::milliseconds(1));
+#ifndef NDEBUG
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore + 1);
+#endif
+    (void)violationsBefore;
+}
@@ -120,3 +120,30 @@ TEST_CASE("Getting new class instance works") {
     REQUIRE(newContainer.get() != nullptr);
     REQUIRE(newContainer.get() != &originalContainer);
 }
+
+TEST_CASE("Batch adding and deleting components keeps container sorted") {
+    ComponentContainer<AComponent> comps;
+
+    comps.addComponent(2, 2);
+    comps.addComponent(5, 5);
+
+    // existing component of entity 5 is replaced, others are merged in
+    comps.addComponents({1, 3, 5, 8}, 7);
+    REQUIRE(comps.getAllComponents().size() == 5);
+    REQUIRE(comps.getComponent(2)->foo == 2);
+    for (auto entity : {1, 3, 5, 8}) {
+        REQUIRE(comps.getComponent(entity)->foo == 7);
+    }
+
+    // entities without component are ignored
+    REQUIRE(comps.genericDeleteComponents({2, 4, 5, 9}) == 2);
+    REQUIRE(comps.getAllComponents().size() == 3);
+    REQUIRE(comps.getComponent(2) == nullptr);
+    REQUIRE(comps.getComponent(5) == nullptr);
+
+    std::vector<EntityID> remaining;
+    for (auto& component : comps.getAllComponents()) {
+        remaining.push_back(component.entityID);
+    }
+    REQUIRE((remaining == std::vector<EntityID>{1, 3, 8}));
+}
@@ -125,6 +125,110 @@ TEST_CASE("Intersection method test - multithreading") {
     REQUIRE(intersection.size() == 100);
 }
 
+TEST_CASE("Intersection method test - thread pool") {
+    ComponentManager comps;
+
+    for (auto i = 1; i <= 3000; i++) {
+        comps.addComponent<FooComponent>(i, i);
+        if (i % 3 == 0) {
+            comps.addComponent<BarComponent>(i);
+        }
+    }
+
+    // results are in entity order, regardless of the number of threads used
+    for (size_t threads : {1, 3, 8}) {
+        ThreadPool pool(threads);
+        comps.setThreadPool(pool);
+        auto result = comps.intersection<FooComponent, BarComponent>();
+
+        REQUIRE(result.size() == 1000);
+        for (size_t i = 0; i < result.size(); i++) {
+            REQUIRE(result[i].entity() == 3 * (i + 1));
+        }
+
+        // every component is visited exactly once by parallelForEach
+        comps.parallelForEach<FooComponent>([](FooComponent& foo) { foo.foo++; });
+    }
+
+    REQUIRE(comps.getComponent<FooComponent>(1)->foo == 4);
+    REQUIRE(comps.getComponent<FooComponent>(3000)->foo == 3003);
+}
+
+TEST_CASE("Intersection of empty container is empty") {
+    ComponentManager comps;
+    REQUIRE((comps.intersection<FooComponent, BarComponent>().empty()));
+}
+
+TEST_CASE("View method test") {
+    ComponentManager comps;
+
+    comps.addComponent<FooComponent>(1, 11);
+    comps.addComponent<BarComponent>(1, 12);
+    comps.addComponent<FooComponent>(2, 21);
+    comps.addComponent<FooComponent>(3, 31);
+    comps.addComponent<BarComponent>(3, 32);
+    comps.addComponent<BarComponent>(4, 42);
+
+    // range-based iteration yields only entities having both components
+    std::vector<EntityID> entities;
+    for (auto entry : comps.view<FooComponent, BarComponent>()) {
+        entities.push_back(std::get<0>(entry));
+        REQUIRE((std::get<1>(entry).foo + 1 == std::get<2>(entry).bar));
+
+        // components are accessed by reference
+        std::get<1>(entry).foo = 0;
+    }
+    REQUIRE((entities == std::vector<EntityID>{1, 3}));
+    REQUIRE(comps.getComponent<FooComponent>(3)->foo == 0);
+    REQUIRE(comps.getComponent<FooComponent>(2)->foo == 21);
+
+    // each() visits the same entities
+    size_t visited = 0;
+    comps.view<BarComponent, FooComponent>().each([&](EntityID entity, BarComponent& bar, FooComponent& foo) {
+        REQUIRE(bar.entityID == entity);
+        REQUIRE(foo.entityID == entity);
+        visited++;
+    });
+    REQUIRE(visited == 2);
+
+    // view with single type visits all its components, empty view is empty
+    auto fooView = comps.view<FooComponent>();
+    REQUIRE(std::distance(fooView.begin(), fooView.end()) == 3);
+    comps.clear<BarComponent>();
+    auto emptyView = comps.view<FooComponent, BarComponent>();
+    REQUIRE(emptyView.begin() == emptyView.end());
+}
+
+TEST_CASE("Const-qualified types give read-only access") {
+    ComponentManager comps;
+    comps.addComponent<FooComponent>(1, 11);
+    comps.addComponent<BarComponent>(1, 12);
+    comps.addComponent<FooComponent>(2, 21);
+
+    // the same components, through pointers and references to const
+    const FooComponent* foo = comps.getComponent<const FooComponent>(1);
+    REQUIRE(foo == comps.getComponent<FooComponent>(1));
+    REQUIRE(foo->foo == 11);
+    REQUIRE((std::is_same<decltype(comps.getAllComponents<const FooComponent>()),
+                          const AlignedVector<FooComponent>&>::value));
+
+    auto intersection = comps.intersection<const FooComponent, BarComponent>();
+    REQUIRE(intersection.size() == 1);
+    REQUIRE(intersection[0].get<const FooComponent>().foo == 11);
+    intersection[0].get<BarComponent>().bar++;
+    REQUIRE(comps.getComponent<BarComponent>(1)->bar == 13);
+
+    int sum = 0;
+    comps.view<const FooComponent>().each([&](EntityID, const FooComponent& foo) { sum += foo.foo; });
+    comps.parallelForEach<const FooComponent>([&](const FooComponent& foo) { sum += foo.foo; });
+    comps.forEachChunk<const FooComponent, 2>([&](const FooComponent* chunk, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            sum += chunk[i].foo;
+        }
+    });
+    REQUIRE(sum == 96);
+}
+
 TEST_CASE("Component handles test") {
     ComponentManager comps;
 
@@ -151,3 +255,184 @@ TEST_CASE("Component handles test") {
     REQUIRE(bComponentHandle);
     REQUIRE(cComponentHandle);
 }
+
+TEST_CASE("Chunked iteration test") {
+    ComponentManager comps;
+    for (auto i = 1; i <= 3001; i++) {
+        comps.addComponent<FooComponent>(i, i);
+    }
+
+    REQUIRE(((uintptr_t)comps.getAllComponents<FooComponent>().data() % componentAlignment == 0));
+
+    for (size_t threads : {1, 4}) {
+        ThreadPool pool(threads);
+        comps.setThreadPool(pool);
+
+        std::atomic<size_t> visited(0), tails(0), misaligned(0);
+        comps.forEachChunk<FooComponent, 8>([&](FooComponent* chunk, size_t count) {
+            if (count != 8) {
+                tails++;
+            }
+            // every chunk starts aligned, if chunks span whole number of alignment blocks
+            if ((8 * sizeof(FooComponent)) % componentAlignment == 0 && (uintptr_t)chunk % componentAlignment != 0) {
+                misaligned++;
+            }
+            for (size_t i = 0; i < count; i++) {
+                chunk[i].foo++;
+            }
+            visited += count;
+        });
+
+        REQUIRE(visited == 3001u);
+        REQUIRE(tails == 1u);
+        REQUIRE(misaligned == 0u);
+    }
+
+    REQUIRE(comps.getComponent<FooComponent>(1)->foo == 3);
+    REQUIRE(comps.getComponent<FooComponent>(3001)->foo == 3003);
+}
+
+TEST_CASE("Intersection with linked EntityManager") {
+    ComponentManager comps;
+    EntityManager entities(comps);
+    comps.setEntityManager(entities);
+
+    auto created = entities.createEntities(100);
+    for (size_t i = 0; i < created.size(); i++) {
+        comps.addComponent<FooComponent>(created[i], (int)i);
+        if (i % 4 == 0) {
+            comps.addComponent<BarComponent>(created[i]);
+        }
+    }
+    comps.deleteComponent<BarComponent>(created[0]);
+
+    auto result = comps.intersection<FooComponent, BarComponent>();
+    REQUIRE(result.size() == 24);
+    for (auto& components : result) {
+        REQUIRE((components.get<FooComponent>().foo % 4 == 0));
+        REQUIRE(components.get<FooComponent>().foo != 0);
+    }
+}
+
+TEST_CASE("Intersection is driven by the smallest container") {
+    ComponentManager comps;
+    for (auto i = 1; i <= 1000; i++) {
+        comps.addComponent<FooComponent>(i, i);
+    }
+    for (auto i : {999, 5, 500, 1001}) {
+        comps.addComponent<BarComponent>(i, i);
+    }
+
+    auto result = comps.intersection<FooComponent, BarComponent>();
+    REQUIRE(result.size() == 3);
+    for (size_t i = 0; i < result.size(); i++) {
+        REQUIRE(result[i].get<FooComponent>().foo == result[i].get<BarComponent>().bar);
+        REQUIRE(result[i].get<FooComponent>().entityID == result[i].entity());
+    }
+    REQUIRE(result[0].entity() == 5);
+    REQUIRE(result[2].entity() == 999);
+}
+
+TEST_CASE("Component cursor finds components in any order") {
+    ComponentContainer<FooComponent> container;
+    for (EntityID i = 2; i <= 200; i += 2) {
+        container.addComponent(i, (int)i);
+    }
+
+    ComponentCursor<ComponentContainer<FooComponent>> cursor(&container);
+    for (EntityID i : {1, 2, 3, 64, 66, 199, 200, 201, 4, 100, 100, 50}) {
+        auto component = cursor.find(i);
+        if (i % 2 == 0 && i <= 200) {
+            REQUIRE(component);
+            REQUIRE(component->foo == (int)i);
+        } else {
+            REQUIRE(component == nullptr);
+        }
+    }
+}
+
+struct HiddenComponent : public Component<HiddenComponent> {};
+
+TEST_CASE("View with exclude and optional filters") {
+    for (auto linked : {false, true}) {
+        ComponentManager comps;
+        EntityManager entities(comps);
+        if (linked) {
+            comps.setEntityManager(entities);
+        }
+
+        auto created = entities.createEntities(12);
+        for (size_t i = 0; i < created.size(); i++) {
+            comps.addComponent<FooComponent>(created[i], (int)i);
+            if (i % 2 == 0) {
+                comps.addComponent<BarComponent>(created[i], (int)i);
+            }
+            if (i % 3 == 0) {
+                comps.addComponent<HiddenComponent>(created[i]);
+            }
+        }
+
+        // entities 1, 2, 4, 5, 7, 8, 10, 11 aren't hidden, even ones have BarComponent
+        std::vector<int> visible;
+        size_t withBar = 0;
+        comps.view<FooComponent>(exclude<HiddenComponent>, optional<BarComponent>)
+            .each([&](EntityID, FooComponent& foo, BarComponent* bar) {
+                visible.push_back(foo.foo);
+                if (bar) {
+                    REQUIRE(bar->bar == foo.foo);
+                    withBar++;
+                }
+            });
+        REQUIRE((visible == std::vector<int>{1, 2, 4, 5, 7, 8, 10, 11}));
+        REQUIRE(withBar == 4);
+
+        // order of filters doesn't matter, and they work in range-based for
+        size_t count = 0;
+        for (auto entry : comps.view<FooComponent, BarComponent>(optional<HiddenComponent>, exclude<>)) {
+            REQUIRE((std::get<3>(entry) != nullptr) == (std::get<1>(entry).foo % 3 == 0));
+            count++;
+        }
+        REQUIRE(count == 6);
+
+        count = 0;
+        for (auto entry : comps.view<BarComponent>(exclude<HiddenComponent>)) {
+            REQUIRE((std::get<1>(entry).bar % 6 != 0));
+            count++;
+        }
+        REQUIRE(count == 4);
+    }
+}
+
+struct SortedTagComponent : public Component<SortedTagComponent> {
+    using Storage = SortedStorage;
+};
+
+TEST_CASE("Tag components are stored as sets of owners") {
+    REQUIRE(isTagComponent<HiddenComponent>);
+    REQUIRE(!isTagComponent<FooComponent>);
+    REQUIRE((std::is_same<ContainerFor<HiddenComponent>, SparseComponentContainer<HiddenComponent>>::value));
+    REQUIRE((std::is_same<ContainerFor<FooComponent>, ComponentContainer<FooComponent>>::value));
+    REQUIRE((std::is_same<ContainerFor<SortedTagComponent>, ComponentContainer<SortedTagComponent>>::value));
+
+    ComponentManager comps;
+    EntityManager entities(comps);
+    comps.setEntityManager(entities);
+
+    // tagging in reverse order doesn't shift already added tags
+    auto created = entities.createEntities(100);
+    for (auto it = created.rbegin(); it != created.rend(); it++) {
+        comps.addComponent<HiddenComponent>(*it);
+    }
+    auto& tags = comps.getAllComponents<HiddenComponent>();
+    REQUIRE(tags.size() == 100);
+    REQUIRE(tags.front().entityID == created.back());
+
+    for (size_t i = 0; i < created.size(); i += 2) {
+        comps.deleteComponent<HiddenComponent>(created[i]);
+    }
+    REQUIRE(tags.size() == 50);
+    REQUIRE(!entities.hasAll<HiddenComponent>(created[0]));
+    REQUIRE(entities.hasAll<HiddenComponent>(created[1]));
+    REQUIRE(comps.getComponent<HiddenComponent>(created[1]) != nullptr);
+    REQUIRE(comps.getComponent<HiddenComponent>(created[2]) == nullptr);
+}
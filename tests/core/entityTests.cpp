@@ -1,4 +1,6 @@
 #include <catch.hpp>
+#include <algorithm>
+#include <thread>
 #include "ecs/ecs.h"
 using namespace EECS;
 
@@ -48,3 +50,299 @@ TEST_CASE("Entity class works") {
     entity.deleteComponent<FooComponent>();
     REQUIRE_FALSE(entity.component<FooComponent>());
 }
+
+TEST_CASE("Entity ids are recycled with new generation, stale ids are detected") {
+    ComponentManager components;
+    EntityManager entities{components};
+
+    auto first = entities.addEntity().getID();
+    auto second = entities.addEntity().getID();
+    REQUIRE(entities.size() == 2);
+
+    components.addComponent<FooComponent>(first, 1);
+    REQUIRE(entities.deleteEntity(first));
+    REQUIRE_FALSE(entities.deleteEntity(first));
+    REQUIRE(entities.size() == 1);
+
+    // slot of deleted entity is reused, but with different generation
+    auto recycled = entities.addEntity().getID();
+    REQUIRE(entityIndex(recycled) == entityIndex(first));
+    REQUIRE(entityGeneration(recycled) == entityGeneration(first) + 1);
+
+    // stale id doesn't refer to new entity, nor to its components
+    REQUIRE_FALSE(entities.entityExists(first));
+    REQUIRE(entities.entityExists(recycled));
+    REQUIRE(entities.entityExists(second));
+    components.addComponent<FooComponent>(recycled, 2);
+    REQUIRE(components.getComponent<FooComponent>(first) == nullptr);
+    REQUIRE(components.getComponent<FooComponent>(recycled)->foo == 2);
+
+    entities.clear();
+    REQUIRE(entities.size() == 0);
+    REQUIRE_FALSE(entities.entityExists(recycled));
+    REQUIRE_FALSE(entities.entityExists(second));
+    REQUIRE(components.getComponent<FooComponent>(recycled) == nullptr);
+
+    // null entity never exists
+    REQUIRE_FALSE(entities.entityExists(0));
+}
+
+struct BatchComponent : public Component<BatchComponent> {
+    using Storage = SparseStorage;
+
+    explicit BatchComponent(int p = 0) : batch(p) {}
+
+    int batch = 0;
+};
+
+TEST_CASE("Batch creation and destruction of entities") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    auto created = entities.createEntities(1000);
+    REQUIRE(created.size() == 1000);
+    REQUIRE(entities.size() == 1000);
+
+    REQUIRE(components.addComponents<FooComponent>(created, 5) == 1000);
+    REQUIRE(components.addComponents<BatchComponent>({created[0], created[1], 0, 12345}, 6) == 2);
+    REQUIRE(components.getComponent<FooComponent>(created[999])->foo == 5);
+    REQUIRE(components.getComponent<BatchComponent>(created[1])->batch == 6);
+
+    // destroy every other entity, with duplicates and stale ids
+    std::vector<EntityID> destroyed;
+    for (size_t i = 0; i < created.size(); i += 2) {
+        destroyed.push_back(created[i]);
+    }
+    destroyed.push_back(created[0]);
+    destroyed.push_back(12345);
+
+    REQUIRE(entities.destroyEntities(destroyed) == 500);
+    REQUIRE(entities.size() == 500);
+    REQUIRE(components.getAllComponents<FooComponent>().size() == 500);
+    REQUIRE(components.getComponent<BatchComponent>(created[0]) == nullptr);
+    REQUIRE(components.getComponent<BatchComponent>(created[1])->batch == 6);
+    REQUIRE_FALSE(entities.entityExists(created[0]));
+    REQUIRE(entities.entityExists(created[1]));
+
+    // freed slots are reused by next batch
+    auto recreated = entities.createEntities(600);
+    REQUIRE(entities.size() == 1100);
+    REQUIRE(entityGeneration(recreated[0]) == 1);
+    REQUIRE(entityGeneration(recreated[599]) == 0);
+}
+
+struct SignatureComponent : public Component<SignatureComponent> {};
+
+TEST_CASE("Signatures track components of entities") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    auto entity = entities.addEntity();
+    REQUIRE(entities.signature(entity).none());
+    REQUIRE_FALSE((entity.hasAny<FooComponent, SignatureComponent>()));
+
+    entity.addComponent<FooComponent>(1);
+    REQUIRE(entity.hasAll<FooComponent>());
+    REQUIRE_FALSE((entity.hasAll<FooComponent, SignatureComponent>()));
+    REQUIRE((entity.hasAny<FooComponent, SignatureComponent>()));
+
+    components.addComponents<SignatureComponent>({entity});
+    REQUIRE((entity.hasAll<FooComponent, SignatureComponent>()));
+    REQUIRE(entities.signature(entity) == (ComponentContainerID::signature<FooComponent, SignatureComponent>()));
+
+    auto clone = entity.clone();
+    REQUIRE(entities.signature(clone) == entities.signature(entity));
+
+    entity.deleteComponent<FooComponent>();
+    REQUIRE_FALSE(entity.hasAll<FooComponent>());
+    REQUIRE(entity.component<FooComponent>() == nullptr);
+
+    components.clear<SignatureComponent>();
+    REQUIRE(entities.signature(entity).none());
+    REQUIRE(clone.hasAll<FooComponent>());
+    REQUIRE_FALSE(clone.hasAll<SignatureComponent>());
+
+    // reused slot starts with empty signature
+    clone.destroy();
+    auto reused = entities.addEntity();
+    REQUIRE(entities.signature(reused).none());
+    REQUIRE_FALSE(entities.hasAll<FooComponent>(clone));
+}
+
+TEST_CASE("Signatures are updated by command buffers") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    auto entity = entities.addEntity();
+    entity.addComponent<FooComponent>();
+
+    CommandBuffer commands;
+    auto created = commands.createEntity();
+    commands.addComponent<SignatureComponent>(created);
+    commands.addComponent<SignatureComponent>(entity);
+    commands.deleteComponent<FooComponent>(entity);
+    commands.apply(entities, components);
+
+    REQUIRE(entities.signature(entity) == ComponentContainerID::signature<SignatureComponent>());
+    REQUIRE(components.getAllComponents<SignatureComponent>().size() == 2);
+    for (auto& component : components.getAllComponents<SignatureComponent>()) {
+        REQUIRE(entities.hasAll<SignatureComponent>(component.entityID));
+    }
+}
+
+TEST_CASE("Signatures of the same entities are updated concurrently for different types") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    // like two Tasks writing different component types of the same entities
+    auto ids = entities.createEntities(2000);
+    auto update = [&](auto type) {
+        using T = decltype(type);
+        for (auto entityID : ids) {
+            components.addComponent<T>(entityID);
+        }
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            components.deleteComponent<T>(ids[i]);
+        }
+    };
+
+    std::thread foo(update, FooComponent{});
+    std::thread signature(update, SignatureComponent{});
+    foo.join();
+    signature.join();
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        REQUIRE(entities.signature(ids[i]) ==
+                (i % 2 == 0 ? ComponentSignature{} : ComponentContainerID::signature<FooComponent, SignatureComponent>()));
+    }
+}
+
+TEST_CASE("Membership checks work without linked ComponentManager") {
+    ComponentManager components;
+    EntityManager entities{components};
+
+    auto entity = entities.addEntity();
+    entity.addComponent<FooComponent>();
+    REQUIRE(entity.hasAll<FooComponent>());
+    REQUIRE_FALSE(entity.hasAny<SignatureComponent>());
+    REQUIRE(entity.component<FooComponent>() != nullptr);
+}
+
+TEST_CASE("Entities are arranged in hierarchy") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    // root -> a -> c, root -> b
+    auto created = entities.createEntities(5);
+    auto root = created[0], a = created[1], b = created[2], c = created[3], unrelated = created[4];
+    REQUIRE(entities.setParent(a, root));
+    REQUIRE(entities.setParent(b, root));
+    REQUIRE(entities.setParent(c, a));
+
+    REQUIRE(entities.getParent(c) == a);
+    REQUIRE(entities.getParent(root) == 0);
+    auto children = entities.getChildren(root);
+    std::sort(children.begin(), children.end());
+    REQUIRE((children == std::vector<EntityID>{a, b}));
+    REQUIRE(entities.getDescendants(root).size() == 3);
+    REQUIRE(entities.getDescendants(root).back() == c);
+
+    // cycles are rejected
+    REQUIRE(!entities.setParent(root, c));
+    REQUIRE(!entities.setParent(a, a));
+
+    auto& hierarchy = entities.getHierarchy();
+    REQUIRE(hierarchy.entities.size() == 4);
+    REQUIRE((hierarchy.levels == std::vector<size_t>{0, 1, 3, 4}));
+    REQUIRE(hierarchy.entities[0] == root);
+    REQUIRE(hierarchy.parents[0] == Hierarchy::noParent);
+    REQUIRE(hierarchy.entities[3] == c);
+    REQUIRE(hierarchy.entities[hierarchy.parents[3]] == a);
+    for (size_t i = 1; i < hierarchy.entities.size(); i++) {
+        REQUIRE(hierarchy.parents[i] < i);
+        REQUIRE(hierarchy.entities[hierarchy.parents[i]] == entities.getParent(hierarchy.entities[i]));
+    }
+
+    // reparenting moves whole subtree
+    REQUIRE(entities.setParent(a, b));
+    REQUIRE((entities.getHierarchy().levels == std::vector<size_t>{0, 1, 2, 3, 4}));
+    REQUIRE(entities.setParent(b, 0));
+    REQUIRE(entities.getChildren(root).empty());
+    REQUIRE(entities.getHierarchy().entities[0] == b);
+
+    // deleting entity deletes its descendants
+    components.addComponent<FooComponent>(c, 5);
+    REQUIRE(entities.deleteEntity(b));
+    REQUIRE(!entities.entityExists(a));
+    REQUIRE(!entities.entityExists(c));
+    REQUIRE(components.getAllComponents<FooComponent>().empty());
+    REQUIRE(entities.entityExists(root));
+    REQUIRE(entities.entityExists(unrelated));
+    REQUIRE(entities.getHierarchy().entities.empty());
+
+    // deleted child is detached from its parent
+    auto child = entities.addEntity();
+    entities.setParent(child, root);
+    entities.deleteEntity(child);
+    REQUIRE(entities.getChildren(root).empty());
+}
+
+struct HierarchyOffset : public Component<HierarchyOffset> {
+    using Storage = SparseStorage;
+
+    explicit HierarchyOffset(int offset = 0) : offset(offset) {}
+
+    int offset = 0;
+};
+
+TEST_CASE("Hierarchy is propagated in single pass and destroyed in batch") {
+    ComponentManager components;
+    EntityManager entities{components};
+    components.setEntityManager(entities);
+
+    // every entity has offset equal to 1, in a chain and in a wide tree
+    auto chain = entities.createEntities(50);
+    for (size_t i = 1; i < chain.size(); i++) {
+        entities.setParent(chain[i], chain[i - 1]);
+    }
+    auto tree = entities.createEntities(50);
+    for (size_t i = 1; i < tree.size(); i++) {
+        entities.setParent(tree[i], tree[(i - 1) / 2]);
+    }
+    components.addComponents<HierarchyOffset>(chain, 1);
+    components.addComponents<HierarchyOffset>(tree, 1);
+
+    // offsets are arranged in hierarchy order, so they are read by index, like parents
+    auto& hierarchy = entities.getHierarchy();
+    REQUIRE(components.orderBy<HierarchyOffset>(hierarchy.entities) == hierarchy.entities.size());
+    auto& offsets = components.getAllComponents<const HierarchyOffset>();
+
+    std::vector<int> world(hierarchy.entities.size());
+    for (size_t i = 0; i < hierarchy.entities.size(); i++) {
+        REQUIRE(offsets[i].entityID == hierarchy.entities[i]);
+        auto local = offsets[i].offset;
+        world[i] = hierarchy.parents[i] == Hierarchy::noParent ? local : world[hierarchy.parents[i]] + local;
+    }
+
+    for (size_t i = 0; i < hierarchy.entities.size(); i++) {
+        if (hierarchy.entities[i] == chain.back()) {
+            REQUIRE(world[i] == 50);
+        }
+        if (hierarchy.entities[i] == tree.back()) {
+            REQUIRE(world[i] == 6);  // depth of 49th node of binary tree
+        }
+    }
+
+    // lookups still find reordered components
+    REQUIRE(components.getComponent<HierarchyOffset>(tree[7])->entityID == tree[7]);
+
+    REQUIRE(entities.destroyEntities({chain[10], tree[0]}) == 90);
+    REQUIRE(entities.size() == 10);
+    REQUIRE(entities.getHierarchy().entities.size() == 10);
+    REQUIRE(components.getAllComponents<HierarchyOffset>().size() == 10);
+}
@@ -1,4 +1,8 @@
 #include <catch.hpp>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <string>
 #include "ecs/ecs.h"
 using namespace EECS;
 
@@ -128,3 +132,411 @@ TEST_CASE("Priority system works") {
     REQUIRE(aReceiver.lastEvent == 6);
     REQUIRE(bReceiver.lastEvent == 3);
 }
+
+struct CollectingReceiver : Receives<CollectingReceiver, AEvent> {
+    CollectingReceiver(EventQueue& ev) : Receives(ev) {}
+
+    bool receive(AEvent& aEvent) {
+        received.push_back(aEvent.x);
+        return true;
+    }
+
+    std::vector<int> received;
+};
+
+TEST_CASE("Events can be pushed from many threads") {
+    EventQueue events;
+    CollectingReceiver receiver(events);
+
+    std::vector<std::thread> producers;
+    for (int thread = 0; thread < 4; thread++) {
+        producers.emplace_back([&events, thread] {
+            for (int i = 0; i < 1000; i++) {
+                events.emplace<AEvent>(thread * 1000 + i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    events.emit();
+
+    // events of every thread are emitted in order of pushing
+    REQUIRE(receiver.received.size() == 4000);
+    std::vector<int> lastOfThread(4, -1);
+    for (auto x : receiver.received) {
+        REQUIRE(x > lastOfThread[x / 1000]);
+        lastOfThread[x / 1000] = x;
+    }
+
+    // buffers are empty after emitting
+    events.emit();
+    REQUIRE(receiver.received.size() == 4000);
+}
+
+TEST_CASE("Order of emitted events can be made deterministic") {
+    EventQueue events;
+    CollectingReceiver receiver(events);
+    events.setOrder<AEvent>([](const AEvent& a, const AEvent& b) { return a.x < b.x; });
+
+    ThreadPool pool(4);
+    pool.parallelFor(0, 1000, 10, [&events](size_t begin, size_t end) {
+        for (auto i = end; i > begin; i--) {
+            events.emplace<AEvent>((int)i - 1);
+        }
+    });
+    events.emit();
+
+    REQUIRE(receiver.received.size() == 1000);
+    REQUIRE(std::is_sorted(receiver.received.begin(), receiver.received.end()));
+}
+
+struct ReemittingReceiver : Receives<ReemittingReceiver, AEvent> {
+    ReemittingReceiver(EventQueue& ev) : Receives(ev), events(ev) {}
+
+    bool receive(AEvent& aEvent) {
+        received++;
+        if (aEvent.x > 0) {
+            events.emplace<AEvent>(aEvent.x - 1);
+        }
+        return true;
+    }
+
+    EventQueue& events;
+    int received = 0;
+};
+
+TEST_CASE("Events pushed by receivers are emitted by next emit") {
+    EventQueue events;
+    ReemittingReceiver receiver(events);
+
+    events.emplace<AEvent>(2);
+    events.emit();
+    REQUIRE(receiver.received == 1);
+    events.emit();
+    events.emit();
+    REQUIRE(receiver.received == 3);
+    events.emit();
+    REQUIRE(receiver.received == 3);
+}
+
+struct CEvent : Event<CEvent> {
+    CEvent(int z) : z(z) {}
+
+    int z;
+};
+
+struct ThreadSafeReceiver : Receives<ThreadSafeReceiver, AEvent, BEvent> {
+    static constexpr bool threadSafeReceiver = true;
+
+    ThreadSafeReceiver(EventQueue& ev) : Receives(ev) {}
+
+    bool receive(AEvent&) {
+        aEvents++;
+        return true;
+    }
+
+    // every AEvent is received before any BEvent, as BEvent is emitted after AEvent
+    bool receive(BEvent&) {
+        if (aEvents != 100) {
+            misordered = true;
+        }
+        bEvents++;
+        return true;
+    }
+
+    std::atomic<int> aEvents{0};
+    std::atomic<int> bEvents{0};
+    std::atomic<bool> misordered{false};
+};
+
+struct MainThreadReceiver : Receives<MainThreadReceiver, CEvent> {
+    MainThreadReceiver(EventQueue& ev) : Receives(ev) {}
+
+    bool receive(CEvent&) {
+        threads.push_back(std::this_thread::get_id());
+        return true;
+    }
+
+    std::vector<std::thread::id> threads;
+};
+
+TEST_CASE("Event types can be emitted concurrently") {
+    ThreadPool pool(4);
+    EventQueue events;
+    events.setThreadPool(pool);
+    events.setParallelEmit(true);
+
+    REQUIRE((events.emitAfter<BEvent, AEvent>()));
+    REQUIRE((events.emitAfter<CEvent, BEvent>()));
+    REQUIRE_FALSE((events.emitAfter<AEvent, CEvent>()));
+    REQUIRE_FALSE((events.emitAfter<AEvent, AEvent>()));
+
+    ThreadSafeReceiver threadSafe(events);
+    MainThreadReceiver mainThread(events);
+    for (int frame = 0; frame < 10; frame++) {
+        threadSafe.aEvents = 0;
+        threadSafe.bEvents = 0;
+        for (int i = 0; i < 100; i++) {
+            events.emplace<BEvent>(i);
+            events.emplace<AEvent>(i);
+        }
+        events.emplace<CEvent>(frame);
+        events.emit();
+
+        REQUIRE(threadSafe.aEvents == 100);
+        REQUIRE(threadSafe.bEvents == 100);
+    }
+
+    REQUIRE_FALSE(threadSafe.misordered);
+    REQUIRE(mainThread.threads.size() == 10);
+    for (auto thread : mainThread.threads) {
+        REQUIRE(thread == std::this_thread::get_id());
+    }
+}
+
+// pushes BEvent for every received AEvent
+struct ChainingReceiver : Receives<ChainingReceiver, AEvent, BEvent> {
+    ChainingReceiver(EventQueue& ev) : Receives(ev), queue(ev) {}
+
+    bool receive(AEvent& event) {
+        queue.emplace<BEvent>(event.x);
+        return true;
+    }
+
+    bool receive(BEvent&) {
+        bEvents++;
+        return true;
+    }
+
+    EventQueue& queue;
+    int bEvents = 0;
+};
+
+TEST_CASE("Events pushed for later types are emitted by next emit, whether emitted concurrently or not") {
+    ThreadPool pool(4);
+    for (auto parallel : {false, true}) {
+        EventQueue events;
+        events.setThreadPool(pool);
+        events.setParallelEmit(parallel);
+        REQUIRE((events.emitAfter<BEvent, AEvent>()));
+
+        ChainingReceiver receiver(events);
+        events.emplace<AEvent>(1);
+        events.emit();
+        REQUIRE(receiver.bEvents == 0);
+
+        events.emit();
+        REQUIRE(receiver.bEvents == 1);
+        events.emit();
+        REQUIRE(receiver.bEvents == 1);
+    }
+}
+
+struct BatchReceiver : Receives<BatchReceiver, AEvent, BEvent> {
+    BatchReceiver(EventQueue& ev) : Receives(ev) {}
+
+    void receiveBatch(EventSpan<AEvent> events) {
+        batches++;
+        for (auto& event : events) {
+            sum += event.x;
+        }
+    }
+
+    void receiveBatch(EventSpan<BEvent> events) { bEvents += events.size(); }
+
+    int batches = 0;
+    long long sum = 0;
+    size_t bEvents = 0;
+};
+
+// consumes events with odd values
+struct OddFilter : Receives<OddFilter, AEvent> {
+    OddFilter(EventQueue& ev) : Receives(ev) {}
+
+    bool receive(AEvent& event) { return event.x % 2 == 0; }
+};
+
+TEST_CASE("Receivers can receive events in batches") {
+    EventQueue events;
+    BatchReceiver batchReceiver(events);
+    Receiver receiver(events);
+
+    for (int i = 1; i <= 50000; i++) {
+        events.emplace<AEvent>(i);
+    }
+    events.emplace<BEvent>(7);
+    events.emit();
+
+    REQUIRE(batchReceiver.batches == 1);
+    REQUIRE(batchReceiver.sum == 50000LL * 50001 / 2);
+    REQUIRE(batchReceiver.bEvents == 1);
+    REQUIRE(receiver.lastAEvent == 50000);
+    REQUIRE(receiver.lastBEvent == 7);
+
+    // events consumed by receivers of higher priority aren't passed to further ones
+    OddFilter filter(events);
+    events.setPriority<AEvent>(filter, -1);
+    for (int i = 1; i <= 10; i++) {
+        events.emplace<AEvent>(i);
+    }
+    events.emit();
+    REQUIRE(batchReceiver.batches == 2);
+    REQUIRE(batchReceiver.sum == 50000LL * 50001 / 2 + 2 + 4 + 6 + 8 + 10);
+
+    // disconnected batch receiver isn't called anymore
+    events.disconnect<AEvent>(batchReceiver);
+    events.emplace<AEvent>(1);
+    events.emit();
+    REQUIRE(batchReceiver.batches == 2);
+}
+
+TEST_CASE("Events can be dispatched immediately") {
+    EventQueue events;
+    Receiver receiver(events);
+    BatchReceiver batchReceiver(events);
+
+    events.dispatchNow<AEvent>(5);
+    REQUIRE(receiver.lastAEvent == 5);
+    REQUIRE(batchReceiver.sum == 5);
+
+    // immediate mode applies to single event type
+    events.setImmediate<AEvent>(true);
+    events.emplace<AEvent>(6);
+    events.push(AEvent(7));
+    events.emplace<BEvent>(8);
+    REQUIRE(receiver.lastAEvent == 7);
+    REQUIRE(receiver.lastBEvent == -1);
+
+    events.emit();
+    REQUIRE(receiver.lastBEvent == 8);
+    REQUIRE(batchReceiver.batches == 3);
+
+    events.setImmediate<AEvent>(false);
+    events.emplace<AEvent>(9);
+    REQUIRE(receiver.lastAEvent == 7);
+    events.emit();
+    REQUIRE(receiver.lastAEvent == 9);
+}
+
+TEST_CASE("Events pushed during emission can be delivered in the same call") {
+    EventQueue events;
+    ReemittingReceiver receiver(events);
+
+    events.emplace<AEvent>(2);
+    REQUIRE(events.emitUntilQuiescent(10));
+    REQUIRE(receiver.received == 3);
+
+    // number of rounds is bounded
+    events.emplace<AEvent>(10);
+    REQUIRE_FALSE(events.emitUntilQuiescent(4));
+    REQUIRE(receiver.received == 7);
+    REQUIRE(events.emitUntilQuiescent(10));
+    REQUIRE(receiver.received == 14);
+}
+
+class EventPushingTask : public Task<EventPushingTask> {
+   public:
+    EventPushingTask(ECS& engine) : Task(engine), engine(engine) {}
+
+    void update() { engine.events.emplace<AEvent>(1); }
+
+    ECS& engine;
+};
+
+// chains BEvent to AEvent and stops the main loop, so BEvent is received only if it's emitted in the same iteration
+struct StoppingChainingReceiver : Receives<StoppingChainingReceiver, AEvent, BEvent> {
+    StoppingChainingReceiver(ECS& engine) : Receives(engine.events), engine(engine) {}
+
+    bool receive(AEvent& event) {
+        engine.events.emplace<BEvent>(event.x);
+        engine.stop();
+        return true;
+    }
+
+    bool receive(BEvent&) {
+        bEvents++;
+        return true;
+    }
+
+    ECS& engine;
+    int bEvents = 0;
+};
+
+TEST_CASE("Main loop delivers events pushed by receivers in the same iteration") {
+    ECS engine;
+    auto task = engine.tasks.addTask<EventPushingTask>();
+    task->frequency = std::chrono::milliseconds(1);
+    StoppingChainingReceiver receiver(engine);
+
+    engine.run();
+    REQUIRE(receiver.bEvents == 1);
+}
+
+// event with variable-sized data, allocated from event arena
+struct TextEvent : Event<TextEvent> {
+    TextEvent(EventSpan<char> text) : text(text) {}
+
+    EventSpan<char> text;
+};
+
+struct TextReceiver : Receives<TextReceiver, TextEvent> {
+    TextReceiver(EventQueue& ev) : Receives(ev), events(ev) {}
+
+    bool receive(TextEvent& event) {
+        texts.emplace_back(event.text.begin(), event.text.end());
+
+        // data of events pushed during emission stays valid until they are emitted
+        if (echo) {
+            echo = false;
+            auto text = events.allocate<TextEvent, char>(event.text.size() + 1);
+            std::copy(event.text.begin(), event.text.end(), text.begin());
+            text[event.text.size()] = '!';
+            events.emplace<TextEvent>(text);
+        }
+        return true;
+    }
+
+    EventQueue& events;
+    std::vector<std::string> texts;
+    bool echo = false;
+};
+
+TEST_CASE("Data of events is allocated from recycled arenas") {
+    EventQueue events;
+    TextReceiver receiver(events);
+
+    auto pushText = [&events](const std::string& string) {
+        auto text = events.allocate<TextEvent, char>(string.size());
+        std::copy(string.begin(), string.end(), text.begin());
+        events.emplace<TextEvent>(text);
+    };
+
+    receiver.echo = true;
+    pushText("hello");
+    pushText("world");
+    events.emit();
+    REQUIRE((receiver.texts == std::vector<std::string>{"hello", "world"}));
+    events.emit();
+    REQUIRE(receiver.texts.back() == "hello!");
+
+    // after the first frames, memory is only reused
+    for (int frame = 0; frame < 10; frame++) {
+        for (int i = 0; i < 100; i++) {
+            pushText(std::string(i, 'x'));
+        }
+        events.emit();
+
+        if (frame == 0) {
+            continue;
+        }
+        auto statistics = events.memoryStatistics<TextEvent>();
+        REQUIRE(statistics.eventsHighWaterMark == 100);
+        REQUIRE(statistics.arenaHighWaterMark >= 99 * 100 / 2);
+        REQUIRE(statistics.arenaCapacity == 2 * 64 * 1024);
+    }
+    REQUIRE(receiver.texts.back() == std::string(99, 'x'));
+
+    events.reserve<TextEvent>(1000);
+    REQUIRE(events.memoryStatistics<TextEvent>().eventsCapacity >= 2000);
+}
@@ -0,0 +1,120 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct PooledComponent : public Component<PooledComponent> {
+    using Storage = PooledStorage;
+
+    PooledComponent(int init = 0) : foo(init) {}
+
+    int foo = 0;
+};
+
+struct PooledPartnerComponent : public Component<PooledPartnerComponent> {
+    PooledPartnerComponent(int init = 0) : bar(init) {}
+
+    int bar = 0;
+};
+
+TEST_CASE("Pooled container: basic add/get/delete") {
+    PooledComponentContainer<PooledComponent> comps;
+
+    REQUIRE(comps.addComponent(0) == nullptr);
+    REQUIRE(comps.getComponent(1) == nullptr);
+    REQUIRE(comps.getComponent(1000000) == nullptr);
+
+    comps.addComponent(1, 111);
+    comps.addComponent(2, 222);
+    comps.addComponent(100000, 333);
+
+    REQUIRE(comps.getComponent(1)->foo == 111);
+    REQUIRE(comps.getComponent(2)->foo == 222);
+    REQUIRE(comps.getComponent(100000)->foo == 333);
+    REQUIRE(comps.getAllComponents().size() == 3);
+
+    REQUIRE(comps.deleteComponent(1));
+    REQUIRE_FALSE(comps.deleteComponent(1));
+    REQUIRE(comps.getComponent(1) == nullptr);
+
+    auto sum = 0;
+    for (auto& component : comps.getAllComponents()) {
+        sum += component.foo;
+    }
+    REQUIRE(sum == 555);
+}
+
+TEST_CASE("Pooled container: components never move") {
+    PooledComponentContainer<PooledComponent> comps;
+
+    auto first = comps.addComponent(1, 1);
+    for (auto i = 2; i < 10000; i++) {
+        comps.addComponent(i, i);
+    }
+    for (auto i = 2; i < 10000; i += 2) {
+        comps.deleteComponent(i);
+    }
+
+    REQUIRE(comps.getComponent(1) == first);
+    REQUIRE(comps.validPointer(first, 1));
+
+    // replacing component keeps its address
+    REQUIRE(comps.addComponent(1, 5) == first);
+    REQUIRE(first->foo == 5);
+}
+
+TEST_CASE("Pooled container: pointer to deleted component is invalid, even if its slot was reused") {
+    PooledComponentContainer<PooledComponent> comps;
+
+    auto component = comps.addComponent(1, 1);
+    REQUIRE(comps.validPointer(component, 1));
+    REQUIRE_FALSE(comps.validPointer(component, 2));
+
+    comps.deleteComponent(1);
+    REQUIRE_FALSE(comps.validPointer(component, 1));
+
+    // freed slot is reused for the next component
+    REQUIRE(comps.addComponent(2, 2) == component);
+    REQUIRE_FALSE(comps.validPointer(component, 1));
+    REQUIRE(comps.validPointer(component, 2));
+
+    comps.clear();
+    REQUIRE_FALSE(comps.validPointer(component, 2));
+    REQUIRE(comps.getAllComponents().empty());
+}
+
+TEST_CASE("Handle to pooled component survives structural changes without lookup") {
+    ECS engine;
+    auto entity = engine.entities.addEntity();
+    auto handle = engine.components.addComponent<PooledComponent>(entity, 7);
+    PooledComponent* raw = handle;
+
+    for (auto i = 0; i < 1000; i++) {
+        engine.components.addComponent<PooledComponent>(engine.entities.addEntity(), i);
+    }
+
+    REQUIRE(handle->foo == 7);
+    REQUIRE(raw == engine.components.getComponent<PooledComponent>(entity));
+    REQUIRE(entity.component<PooledComponent>() == raw);
+
+    engine.components.deleteComponent<PooledComponent>(entity);
+    REQUIRE_FALSE(handle);
+}
+
+TEST_CASE("Pooled components can be used in views and intersections") {
+    ComponentManager comps;
+
+    for (EntityID i = 1; i <= 10; i++) {
+        comps.addComponent<PooledComponent>(i, (int)i);
+        if (i % 2 == 0) {
+            comps.addComponent<PooledPartnerComponent>(i, (int)i);
+        }
+    }
+
+    auto sum = 0;
+    comps.view<PooledComponent, PooledPartnerComponent>().each(
+        [&](EntityID, PooledComponent& pooled, PooledPartnerComponent& partner) { sum += pooled.foo + partner.bar; });
+    REQUIRE(sum == 60);
+
+    REQUIRE((comps.intersection<PooledPartnerComponent, PooledComponent>().size() == 5));
+    REQUIRE((comps.intersection<PooledComponent, PooledPartnerComponent>().size() == 5));
+}
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct FrameTime {
+    FrameTime(int delta = 0) : delta(delta) {}
+
+    int delta;
+};
+
+struct Camera {
+    float x = 0, y = 0;
+};
+
+struct ResourcePosition : public Component<ResourcePosition> {
+    int x = 0;
+};
+
+TEST_CASE("Resources are set, replaced and removed", "[Resources]") {
+    Resources resources;
+    REQUIRE(resources.get<FrameTime>() == nullptr);
+    REQUIRE(!resources.has<Camera>());
+
+    auto& time = resources.set<FrameTime>(16);
+    REQUIRE(resources.get<FrameTime>() == &time);
+    REQUIRE(resources.get<FrameTime>()->delta == 16);
+
+    resources.modify<FrameTime>()->delta = 33;
+    REQUIRE(resources.get<FrameTime>()->delta == 33);
+
+    resources.set<FrameTime>(8);
+    resources.set<Camera>().x = 5;
+    REQUIRE(resources.get<FrameTime>()->delta == 8);
+    REQUIRE(resources.get<Camera>()->x == 5);
+
+    // const-qualified type refers to the same resource
+    const Camera* camera = resources.get<const Camera>();
+    REQUIRE(camera == resources.get<Camera>());
+    REQUIRE(resources.has<const Camera>());
+
+    REQUIRE(resources.remove<FrameTime>());
+    REQUIRE(!resources.remove<FrameTime>());
+    REQUIRE(!resources.has<FrameTime>());
+    REQUIRE(resources.has<Camera>());
+
+    resources.clear();
+    REQUIRE(!resources.has<Camera>());
+}
+
+TEST_CASE("Resource access declarations conflicts", "[Resources]") {
+    auto timeReader = ComponentAccess::of<Reads<FrameTime>>();
+    auto otherTimeReader = ComponentAccess::of<Reads<FrameTime, ResourcePosition>>();
+    auto timeWriter = ComponentAccess::of<Writes<FrameTime>>();
+    auto positionWriter = ComponentAccess::of<Reads<Camera>, Writes<ResourcePosition>>();
+
+    REQUIRE(timeReader.canReadResource(ResourceID::get<FrameTime>()));
+    REQUIRE(!timeReader.canWriteResource(ResourceID::get<FrameTime>()));
+    REQUIRE(!timeReader.canRead(ComponentContainerID::get<ResourcePosition>()));
+    REQUIRE(otherTimeReader.canRead(ComponentContainerID::get<ResourcePosition>()));
+
+    REQUIRE(!timeReader.conflictsWith(otherTimeReader));
+    REQUIRE(timeReader.conflictsWith(timeWriter));
+    REQUIRE(timeWriter.conflictsWith(otherTimeReader));
+    REQUIRE(!timeWriter.conflictsWith(positionWriter));
+    REQUIRE(positionWriter.conflictsWith(otherTimeReader));
+}
+
+class FrameTimeReader : public Task<FrameTimeReader, Reads<FrameTime>, Writes<ResourcePosition>> {
+   public:
+    FrameTimeReader(ECS& engine) : Task(engine) {}
+
+    void update() override {
+        for (auto& position : ecs.components.getAllComponents<ResourcePosition>()) {
+            position.x += ecs.resources.get<FrameTime>()->delta;
+        }
+    }
+};
+
+class CameraReader : public Task<CameraReader, Reads<const Camera>> {
+   public:
+    CameraReader(ECS& engine) : Task(engine) {}
+
+    void update() override { x = ecs.resources.get<const Camera>()->x; }
+
+    float x = 0;
+};
+
+class CameraWriter : public Task<CameraWriter, Reads<FrameTime>> {
+   public:
+    CameraWriter(ECS& engine) : Task(engine) {}
+
+    void update() override { ecs.resources.modify<Camera>(); }
+};
+
+TEST_CASE("Tasks access resources of the engine", "[Resources]") {
+    ECS engine;
+    engine.resources.set<FrameTime>(4);
+    engine.components.addComponent<ResourcePosition>(engine.entities.addEntity());
+
+    auto task = engine.tasks.addTask<FrameTimeReader>();
+    task->frequency = std::chrono::milliseconds(1);
+    engine.tasks.update(std::chrono::milliseconds(1));
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(engine.components.getAllComponents<ResourcePosition>()[0].x == 8);
+
+#ifndef NDEBUG
+    // reading resource through const-qualified type matches declaration of the type, with or without const
+    auto violationsBefore = ComponentAccess::violationCount();
+    engine.resources.set<Camera>().x = 3;
+    auto reader = engine.tasks.addTask<CameraReader>();
+    reader->frequency = std::chrono::milliseconds(1);
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(reader->x == 3);
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore);
+    engine.tasks.deleteTask<CameraReader>();
+
+    // writing resource which is only read, or not declared at all, is reported
+    engine.tasks.addTask<CameraWriter>()->frequency = std::chrono::milliseconds(1);
+    engine.tasks.update(std::chrono::milliseconds(1));
+    REQUIRE(ComponentAccess::violationCount() == violationsBefore + 1);
+#endif
+}
@@ -0,0 +1,145 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct SoAPosition : public Component<SoAPosition> {
+    using Storage = SoAStorage;
+    static auto fields() { return std::make_tuple(&SoAPosition::x, &SoAPosition::y); }
+
+    SoAPosition(float x = 0, float y = 0) : x(x), y(y) {}
+
+    float x = 0, y = 0;
+};
+
+TEST_CASE("SoA container: basic add/get/delete") {
+    SoAComponentContainer<SoAPosition> comps;
+
+    REQUIRE(comps.addComponent(0) == nullptr);
+    REQUIRE(comps.getComponent(1) == nullptr);
+
+    comps.addComponent(3, 3.0f, 30.0f);
+    comps.addComponent(1, 1.0f, 10.0f);
+    comps.addComponent(2, 2.0f, 20.0f);
+
+    auto component = comps.getComponent(2);
+    REQUIRE(component);
+    REQUIRE(component.entityID() == 2);
+    REQUIRE(component.get<0>() == 2.0f);
+    REQUIRE(component.get<1>() == 20.0f);
+
+    auto& all = comps.getAllComponents();
+    REQUIRE(all.size() == 3);
+    REQUIRE((all.entities() == std::vector<EntityID>{1, 2, 3}));
+
+    REQUIRE(comps.deleteComponent(2));
+    REQUIRE_FALSE(comps.deleteComponent(2));
+    REQUIRE(comps.getComponent(2) == nullptr);
+    REQUIRE(comps.getComponent(3).get<1>() == 30.0f);
+
+    comps.clear();
+    REQUIRE(comps.getAllComponents().empty());
+}
+
+TEST_CASE("SoA container: reference loads and stores whole component") {
+    SoAComponentContainer<SoAPosition> comps;
+    auto reference = comps.addComponent(5, 1.0f, 2.0f);
+
+    auto copy = reference.load();
+    REQUIRE(copy.entityID == 5);
+    REQUIRE(copy.x == 1.0f);
+    REQUIRE(copy.y == 2.0f);
+
+    copy.x = 7.0f;
+    copy.entityID = 100;
+    reference.store(copy);
+    REQUIRE(comps.getComponent(5).get<0>() == 7.0f);
+    REQUIRE(comps.getComponent(100) == nullptr);
+
+    // replacing keeps single component
+    comps.addComponent(5, 9.0f, 9.0f);
+    REQUIRE(comps.getAllComponents().size() == 1);
+    REQUIRE(comps.getComponent(5).get<1>() == 9.0f);
+}
+
+TEST_CASE("SoA container: field arrays are contiguous and follow entity order") {
+    SoAComponentContainer<SoAPosition> comps;
+    for (EntityID i = 100; i > 0; i--) {
+        comps.addComponent(i, (float)i, 0.0f);
+    }
+
+    auto& all = comps.getAllComponents();
+    auto xs = all.fieldArray<0>();
+    auto ys = all.fieldArray<1>();
+    for (size_t i = 0; i < all.size(); i++) {
+        ys[i] += xs[i] * 2.0f;
+    }
+
+    for (EntityID i = 1; i <= 100; i++) {
+        REQUIRE(comps.getComponent(i).get<1>() == i * 2.0f);
+    }
+}
+
+TEST_CASE("SoA container: batched add and delete") {
+    SoAComponentContainer<SoAPosition> comps;
+    comps.addComponent(2, 2.0f, 0.0f);
+    comps.addComponent(4, 4.0f, 0.0f);
+
+    comps.addComponents({1, 2, 3, 5}, 8.0f, 1.0f);
+    auto& all = comps.getAllComponents();
+    REQUIRE((all.entities() == std::vector<EntityID>{1, 2, 3, 4, 5}));
+    REQUIRE(comps.getComponent(2).get<0>() == 8.0f);
+    REQUIRE(comps.getComponent(4).get<0>() == 4.0f);
+    REQUIRE(comps.getComponent(5).get<1>() == 1.0f);
+
+    REQUIRE(comps.genericDeleteComponents({2, 3, 6}) == 2);
+    REQUIRE((all.entities() == std::vector<EntityID>{1, 4, 5}));
+    REQUIRE(comps.getComponent(4).get<0>() == 4.0f);
+    REQUIRE(comps.getComponent(5).get<0>() == 8.0f);
+}
+
+TEST_CASE("SoA components through ComponentManager") {
+    ECS engine;
+    auto first = engine.entities.addEntity();
+    auto second = engine.entities.addEntity();
+
+    auto added = engine.components.addComponent<SoAPosition>(first, 1.0f, 2.0f);
+    REQUIRE(added.get<1>() == 2.0f);
+    REQUIRE_FALSE(engine.components.addComponent<SoAPosition>(0));
+
+    engine.entities.cloneEntity(first);
+    REQUIRE(engine.components.getAllComponents<SoAPosition>().size() == 2);
+
+    engine.components.addComponents<SoAPosition>({first, second}, 3.0f, 3.0f);
+    REQUIRE(engine.components.getComponent<SoAPosition>(second).get<0>() == 3.0f);
+
+    engine.entities.deleteEntity(first);
+    REQUIRE(engine.components.getComponent<SoAPosition>(first) == nullptr);
+    REQUIRE(engine.components.getAllComponents<SoAPosition>().size() == 2);
+}
+
+TEST_CASE("SoA components in chunked iteration") {
+    ComponentManager comps;
+    for (EntityID i = 1; i <= 100; i++) {
+        comps.addComponent<SoAPosition>(i, (float)i, 1.0f);
+    }
+
+    using Chunk = SoAComponentContainer<SoAPosition>::Components::Chunk;
+    size_t tails = 0;
+    comps.forEachChunk<SoAPosition, 16>([&](Chunk chunk, size_t count) {
+        auto xs = chunk.field<0>();
+        auto ys = chunk.field<1>();
+        if (count == 16) {
+            REQUIRE(((uintptr_t)xs % componentAlignment == 0));
+        } else {
+            tails++;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            xs[i] += ys[i];
+            REQUIRE(chunk.entities()[i] == (EntityID)(xs[i] - 1.0f));
+        }
+    });
+
+    REQUIRE(tails == 1u);
+    REQUIRE(comps.getComponent<SoAPosition>(100).get<0>() == 101.0f);
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+using namespace EECS;
+
+struct SparseComponent : public Component<SparseComponent> {
+    using Storage = SparseStorage;
+
+    SparseComponent(int init = 0) : foo(init) {}
+
+    int foo = 0;
+};
+
+TEST_CASE("Sparse container: adding component to null entity is impossible and yields nullptr") {
+    SparseComponentContainer<SparseComponent> comps;
+
+    REQUIRE(comps.addComponent(0) == nullptr);
+    REQUIRE(comps.getComponent(0) == nullptr);
+}
+
+TEST_CASE("Sparse container: basic add/get/delete") {
+    SparseComponentContainer<SparseComponent> comps;
+
+    // there were never such objects here, including entities far beyond allocated pages
+    REQUIRE(comps.getComponent(1) == nullptr);
+    REQUIRE(comps.getComponent(1000000) == nullptr);
+
+    comps.addComponent(1, 111);
+    comps.addComponent(2, 222);
+    comps.addComponent(100000, 333);
+
+    REQUIRE(comps.getComponent(1)->foo == 111);
+    REQUIRE(comps.getComponent(2)->foo == 222);
+    REQUIRE(comps.getComponent(100000)->foo == 333);
+    REQUIRE(comps.getComponent(3) == nullptr);
+
+    // adding component to entity which already has one replaces it
+    comps.addComponent(2, 444);
+    REQUIRE(comps.getAllComponents().size() == 3);
+    REQUIRE(comps.getComponent(2)->foo == 444);
+
+    REQUIRE(comps.deleteComponent(1));
+    REQUIRE_FALSE(comps.deleteComponent(1));
+    REQUIRE(comps.genericDeleteComponent(100000));
+
+    REQUIRE(comps.getComponent(1) == nullptr);
+    REQUIRE(comps.getComponent(100000) == nullptr);
+    REQUIRE(comps.getComponent(2)->foo == 444);
+}
+
+TEST_CASE("Sparse container: deletion keeps dense array packed and remaps moved component") {
+    SparseComponentContainer<SparseComponent> comps;
+
+    for (auto i = 1; i <= 5; i++) {
+        comps.addComponent(i, i * 10);
+    }
+
+    // deleting from the middle moves last component into freed slot
+    comps.deleteComponent(2);
+    REQUIRE(comps.getAllComponents().size() == 4);
+    REQUIRE(comps.getAllComponents()[1].entityID == 5);
+
+    for (auto i : {1, 3, 4, 5}) {
+        REQUIRE(comps.getComponent(i) != nullptr);
+        REQUIRE(comps.getComponent(i)->foo == i * 10);
+    }
+
+    // deleting last component doesn't move anything
+    comps.deleteComponent(4);
+    REQUIRE(comps.getAllComponents().size() == 3);
+    REQUIRE(comps.getComponent(5)->foo == 50);
+}
+
+TEST_CASE("Sparse container: stale generation of entity doesn't own its component") {
+    SparseComponentContainer<SparseComponent> comps;
+    auto stale = makeEntityID(5, 0);
+    auto current = makeEntityID(5, 1);
+
+    comps.addComponent(stale, 1);
+    REQUIRE(comps.getComponent(current) == nullptr);
+    REQUIRE_FALSE(comps.deleteComponent(current));
+
+    // newer generation replaces component of the stale one
+    comps.addComponent(current, 2);
+    REQUIRE(comps.getComponent(stale) == nullptr);
+    REQUIRE(comps.getComponent(current)->foo == 2);
+    REQUIRE(comps.getAllComponents().size() == 1);
+}
+
+TEST_CASE("Sparse container: cloning and clearing works") {
+    SparseComponentContainer<SparseComponent> comps;
+
+    comps.addComponent(1, 7);
+    REQUIRE(comps.cloneComponent(1, 2));
+    REQUIRE_FALSE(comps.cloneComponent(3, 4));
+
+    comps.getComponent(2)->foo = 8;
+    REQUIRE(comps.getComponent(1)->foo == 7);
+    REQUIRE(comps.getComponent(2)->foo == 8);
+    REQUIRE(comps.getComponent(2)->entityID == 2);
+
+    comps.clear();
+    REQUIRE(comps.getComponent(1) == nullptr);
+    REQUIRE(comps.getComponent(2) == nullptr);
+}
+
+TEST_CASE("ComponentManager uses storage selected by component type") {
+    ComponentManager comps;
+
+    comps.addComponent<SparseComponent>(3, 3);
+    comps.addComponent<SparseComponent>(1, 1);
+
+    // sparse storage keeps insertion order, unlike sorted storage
+    REQUIRE(comps.getAllComponents<SparseComponent>()[0].entityID == 3);
+    REQUIRE(comps.getComponent<SparseComponent>(1)->foo == 1);
+    REQUIRE(comps.getComponentHandle<SparseComponent>(3)->foo == 3);
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+#include "include/ecs/ecs.h"
+#include "experimental/archetypeContainer.h"
+using namespace EECS;
+
+struct ArchPosition : public Component<ArchPosition> {
+    ArchPosition(int x = 0) : x(x) {}
+
+    int x = 0;
+};
+
+struct ArchVelocity : public Component<ArchVelocity> {
+    ArchVelocity(double dx = 0) : dx(dx) {}
+
+    double dx = 0;
+};
+
+struct ArchTracked : public Component<ArchTracked> {
+    ArchTracked() { alive++; }
+    ArchTracked(const ArchTracked&) { alive++; }
+    ArchTracked(ArchTracked&&) { alive++; }
+    ArchTracked& operator=(const ArchTracked&) = default;
+    ArchTracked& operator=(ArchTracked&&) = default;
+    ~ArchTracked() { alive--; }
+
+    static int alive;
+};
+
+int ArchTracked::alive = 0;
+
+TEST_CASE("Archetype container: adding, getting and deleting components") {
+    ArchetypeContainer container;
+
+    REQUIRE(container.addComponent<ArchPosition>(0, 1) == nullptr);
+
+    auto position = container.addComponent<ArchPosition>(1, 11);
+    REQUIRE(position);
+    REQUIRE(position->x == 11);
+    REQUIRE(position->entityID == 1);
+
+    // adding second component migrates entity, but keeps previous component
+    container.addComponent<ArchVelocity>(1, 1.5);
+    REQUIRE(container.getComponent<ArchPosition>(1)->x == 11);
+    REQUIRE(container.getComponent<ArchVelocity>(1)->dx == 1.5);
+
+    // replacing existing component doesn't migrate
+    auto archetypes = container.archetypeCount();
+    container.addComponent<ArchPosition>(1, 12);
+    REQUIRE(container.getComponent<ArchPosition>(1)->x == 12);
+    REQUIRE(container.archetypeCount() == archetypes);
+
+    REQUIRE(container.deleteComponent<ArchPosition>(1));
+    REQUIRE_FALSE(container.deleteComponent<ArchPosition>(1));
+    REQUIRE(container.getComponent<ArchPosition>(1) == nullptr);
+    REQUIRE(container.getComponent<ArchVelocity>(1)->dx == 1.5);
+
+    REQUIRE(container.deleteEntity(1));
+    REQUIRE_FALSE(container.deleteEntity(1));
+    REQUIRE(container.getComponent<ArchVelocity>(1) == nullptr);
+}
+
+TEST_CASE("Archetype container: query visits only entities with all requested types") {
+    ArchetypeContainer container;
+
+    // enough entities to span several chunks
+    for (EntityID entity = 1; entity <= 5000; entity++) {
+        container.addComponent<ArchPosition>(entity, (int)entity);
+        if (entity % 2 == 0) {
+            container.addComponent<ArchVelocity>(entity, 1.0);
+        }
+    }
+
+    REQUIRE(container.count<ArchPosition>() == 5000);
+    REQUIRE((container.count<ArchPosition, ArchVelocity>() == 2500));
+
+    size_t visited = 0;
+    container.forEach<ArchPosition, ArchVelocity>([&](EntityID entity, ArchPosition& position, ArchVelocity& velocity) {
+        REQUIRE((entity % 2 == 0));
+        REQUIRE(position.entityID == entity);
+        position.x += (int)velocity.dx;
+        visited++;
+    });
+    REQUIRE(visited == 2500);
+
+    REQUIRE(container.getComponent<ArchPosition>(10)->x == 11);
+    REQUIRE(container.getComponent<ArchPosition>(11)->x == 11);
+
+    // removing entities from the middle keeps remaining ones reachable
+    for (EntityID entity = 2; entity <= 5000; entity += 4) {
+        container.deleteEntity(entity);
+    }
+    REQUIRE((container.count<ArchPosition, ArchVelocity>() == 1250));
+    REQUIRE(container.getComponent<ArchPosition>(4)->x == 5);
+    REQUIRE(container.getComponent<ArchPosition>(5000)->x == 5001);
+}
+
+TEST_CASE("Archetype container: components are destroyed exactly once") {
+    {
+        ArchetypeContainer container;
+        for (EntityID entity = 1; entity <= 100; entity++) {
+            container.addComponent<ArchTracked>(entity);
+            container.addComponent<ArchPosition>(entity);
+        }
+        REQUIRE(ArchTracked::alive == 100);
+
+        container.deleteComponent<ArchTracked>(1);
+        container.deleteEntity(2);
+        REQUIRE(ArchTracked::alive == 98);
+
+        container.clear();
+        REQUIRE(ArchTracked::alive == 0);
+
+        container.addComponent<ArchTracked>(1);
+    }
+    REQUIRE(ArchTracked::alive == 0);
+}